@@ -10,22 +10,47 @@
 
 #include "algorithm.hpp"
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <limits.h>
+#include <queue>
 
 using namespace std;
 
-Algorithm::Algorithm(std::size_t numAttributes)
-    : m_numAttributes(numAttributes){}
+Algorithm::Algorithm(std::size_t numAttributes, Stats * stats)
+    : m_numAttributes(numAttributes), m_cutpointMode(CUT_ALL),
+      m_maxCutpoints(256), m_selection(SELECT_FULL), m_weights(nullptr),
+      m_inputCases(nullptr), m_blockStore(nullptr), m_sampleFraction(0), m_sampler(nullptr),
+      m_sampleRulesKept(0), m_sampleRulesRejected(0), m_sampleCasesCovered(0),
+      m_conceptCases(0), m_sampleSeconds(0), m_exactSeconds(0),
+      m_speculativeSeeds(0), m_speculativeThreads(0), m_speculativeRounds(0),
+      m_speculativeKept(0), m_speculativeDiscarded(0), m_hasDeadline(false),
+      m_deadlineReached(false), m_quickRules(0), m_skippedDropConditions(0),
+      m_skippedDropRules(0), m_checkpoint(nullptr),
+      m_conceptIndex(0), m_rulesetWriter(nullptr), m_stats(stats), m_warnings(&cerr){}
+
+void Algorithm::generateAVBlocks(Dataset * data, const set<int> * cases){
+    ScopedTimer timer(m_stats, PHASE_BLOCKS);
+    MemScope memScope(MEM_BLOCKS);
+    TraceSpan span("generateAVBlocks");
 
-void Algorithm::generateAVBlocks(Dataset * data){
     // FOR: Each attribute (column)
     for(unsigned col = 0; col < m_numAttributes; col++){
         string attr = data->getAttribute(col);
+        size_t firstBlock = m_avBlocks.size();
+        TraceSpan discretizeSpan("discretize", attr);
 
         // IF: Attribute values are numeric
         if(data->getValue(1, col)->isNumeric()){
             float min = 0, max = 0;
-            list<float> cutpoints = data->discretize(col, min, max);
+            list<float> cutpoints;
+            if(m_cutpointMode == CUT_BOUNDARY){
+                cutpoints = data->discretizeBoundaries(col, min, max, cases);
+            } else if(m_cutpointMode == CUT_QUANTILE){
+                cutpoints = data->discretizeQuantiles(col, min, max, m_maxCutpoints, cases);
+            } else {
+                cutpoints = data->discretize(col, min, max, cases);
+            }
             #if DEBUG==true
                 cout << "NUMERIC: Cutpoints for " << attr << ": ";
                 for(float c : cutpoints){
@@ -42,7 +67,7 @@ void Algorithm::generateAVBlocks(Dataset * data){
         }
         // ELSE: Attribute values are symbolic
         else {
-            list<string> values = data->getPossibleValues(col);
+            list<string> values = data->getPossibleValues(col, cases);
             #if DEBUG==true
                 cout << "SYMBOLIC: Possible values for " << attr << ": ";
                 for(string str : values){
@@ -56,26 +81,87 @@ void Algorithm::generateAVBlocks(Dataset * data){
                 m_avBlocks.push_back(new AVSymbolic(attr, col, v));
             }
         }
+        discretizeSpan.end();
+
+        // Populate attribute-value blocks of this attribute
+        TraceSpan buildSpan("buildBlocks", attr);
+        // LOOP: For each attribute-value block
+        for(unsigned i = firstBlock; i < m_avBlocks.size(); i++){
+
+            // IF: Blocks are kept out of core, write the block as a bitmap row
+            if(m_blockStore && storeBlock(data, i, cases)){
+                continue;
+            }
+
+            // LOOP: For each case (row), add matching values to the block
+            for(unsigned r = 1; r <= data->getNumCases(); r++){
+                if(!cases || cases->count(r)){
+                    m_avBlocks[i]->addOnMatch(data->getValue(r, col), r);    
+                }
+            }
+
+            #if DEBUG == true
+               m_avBlocks[i]->print();
+            #endif
+        }
     } // END FOR
 
-    // Populate attribute-value blocks
-    // LOOP: For each attribute-value block
-    for(unsigned i = 0; i < m_avBlocks.size(); i++){
+    // IF: Stored rows cannot be mapped, rebuild those blocks in memory
+    if(m_blockStore && !m_blockStore->seal()){
+        cerr << "Unable to map block store; keeping blocks in memory" << endl;
+        for(AV * av : m_avBlocks){
+            av->setBlock(set<int>());
+            for(unsigned r = 1; r <= data->getNumCases(); r++){
+                if(!cases || cases->count(r)){
+                    av->addOnMatch(data->getValue(r, av->getAttrCol()), r);
+                }
+            }
+        }
+    }
 
-        // LOOP: For each case (row), add matching values to the block
-        for(unsigned r = 1; r <= data->getNumCases(); r++){
-            int c = m_avBlocks[i]->getAttrCol();
-            
-            m_avBlocks[i]->addOnMatch(data->getValue(r, c), r);    
+    // IF: Recording statistics, count the runs of consecutive cases in the blocks
+    if(m_stats && !m_blockStore){
+        for(AV * av : m_avBlocks){
+            set<int> block = av->getBlock();
+            size_t runs = 0;
+            int previous = -1;
+            for(int x : block){
+                if(x != previous + 1){
+                    runs++;
+                }
+                previous = x;
+            }
+            m_stats->count(COUNT_BLOCK_RUNS, runs);
         }
+    }
+    indexDuplicates();
+}
 
-        #if DEBUG == true
-           m_avBlocks[i]->print();
-        #endif
+bool Algorithm::storeBlock(Dataset * data, int i, const set<int> * cases){
+    vector<uint64_t> bits(m_blockStore->getRowWords(), 0);
+    int col = m_avBlocks[i]->getAttrCol();
+    for(unsigned r = 1; r <= data->getNumCases(); r++){
+        if((!cases || cases->count(r)) && m_avBlocks[i]->matches(data->getValue(r, col))){
+            bits[r / 64] |= 1ULL << (r % 64);
+        }
+    }
+    size_t row = 0;
+    if(!m_blockStore->addRow(bits, row)){
+        return false;
     }
+    m_avBlocks[i]->setStoreRow(m_blockStore, row);
+    return true;
+}
+
+void Algorithm::setCutpointMode(CutpointMode mode, size_t maxCutpoints){
+    m_cutpointMode = mode;
+    m_maxCutpoints = maxCutpoints;
 }
 
 vector<Concept *> Algorithm::generateConcepts(Dataset * data){
+    ScopedTimer timer(m_stats, PHASE_CONCEPTS);
+    MemScope memScope(MEM_CONCEPTS);
+    TraceSpan span("generateConcepts");
     vector <Concept *> concepts;
     list<string> values = data->getPossibleValues(m_numAttributes);
     for(string v : values){
@@ -99,77 +185,674 @@ vector<Concept *> Algorithm::generateConcepts(Dataset * data){
 void Algorithm::generateRuleset(ostream & file, Dataset * data){
     // Generate program components
     generateAVBlocks(data);
-    vector <Concept *> concepts = generateConcepts(data);
+    generateRules(file, data);
+}
+
+void Algorithm::generateRules(ostream & file, Dataset * data){
+    generateRules(file, generateConcepts(data));
+}
+
+void Algorithm::generateRules(ostream & file, vector<Concept *> concepts){
+    vector<string> labels(m_avBlocks.size());
+
+    // IF: Sampling, set up induction on the sample's blocks first
+    if(m_sampleFraction > 0 && m_sampleFraction < 1){
+        prepareSample(concepts);
+    }
 
     // FOR: Each concept, generate rules and print to stream
-    for(Concept * concept : concepts){
+    for(m_conceptIndex = 0; m_conceptIndex < concepts.size(); m_conceptIndex++){
+        Concept * concept = concepts[m_conceptIndex];
         #if DEBUG == true
             cout << concept->toString() << endl;
         #endif
         
-        LocalCover rules = induceRules(concept);
-        file << rules.toString(m_avBlocks);
+        ScopedTimer conceptTimer(m_stats, PHASE_INDUCTION);
+        LocalCover rules(concept);
+        // IF: Checkpoint has this concept finished, take its rules as they were
+        if(!m_checkpoint || !m_checkpoint->resumeFinished(m_conceptIndex, rules)){
+            rules = induceRules(concept);
+        }
+        if(m_checkpoint){
+            m_checkpoint->finish(m_conceptIndex, rules);
+        }
+        double seconds = conceptTimer.stop();
+        if(m_stats){
+            m_stats->addConcept(concept->labelString(), seconds, rules.size());
+            // Totals for comparing rulesets: conditions and strength of every rule
+            for(Rule * rule : rules.getRules()){
+                m_stats->count(COUNT_RULE_CONDITIONS, rule->size());
+                m_stats->count(COUNT_RULE_STRENGTH, weightedSize(
+                    setIntersection(rule->getBlock(m_avBlocks), concept->getBlock()), m_weights));
+            }
+        }
+
+        ScopedTimer outputTimer(m_stats, PHASE_OUTPUT);
+        MemScope memScope(MEM_OUTPUT);
+        TraceSpan outputSpan("writeRules", concept->getValue());
+        rules.write(file, m_avBlocks, labels, m_weights);
+        if(m_rulesetWriter){
+            m_rulesetWriter->addCover(rules, m_avBlocks, m_weights);
+        }
 
         delete concept;
     }
+    if(m_sampler){
+        finishSample();
+    }
+}
+
+void Algorithm::prepareSample(const vector<Concept *> & concepts){
+    m_sampleCases.clear();
+    // FOR: Each concept, pick cases evenly spread over it
+    for(Concept * concept : concepts){
+        vector<int> B = inInputOrder(concept->getBlock());
+        bool sampled = false;
+        for(size_t j = 0; j < B.size(); j++){
+            if(floor((j + 1) * m_sampleFraction) > floor(j * m_sampleFraction)){
+                m_sampleCases.insert(B[j]);
+                sampled = true;
+            }
+        }
+        if(!B.empty() && !sampled){
+            m_sampleCases.insert(B.front());
+        }
+    }
+
+    // Blocks cut down to the sample; their indices match m_avBlocks
+    for(AV * av : m_avBlocks){
+        AV * masked = av->clone();
+        masked->setBlock(av->intersect(m_sampleCases));
+        m_sampleBlocks.push_back(masked);
+    }
+    m_sampler = new Algorithm(m_numAttributes);
+    m_sampler->setWeights(m_weights);
+    m_sampler->setSelection(m_selection);
+    m_sampler->setAVBlocks(m_sampleBlocks);
 }
 
+void Algorithm::finishSample(){
+    for(AV * av : m_sampleBlocks){
+        delete av;
+    }
+    m_sampleBlocks.clear();
+    delete m_sampler;
+    m_sampler = nullptr;
+}
 
-LocalCover Algorithm::induceRules(Concept * concept){
+void Algorithm::seedFromSample(LocalCover & lc){
+    auto start = chrono::steady_clock::now();
+    Concept * concept = lc.getConcept();
     set<int> B = concept->getBlock();
-    set<int> G = B;
+    Concept sample(concept->getDecision(), concept->getValue());
+    for(int x : setIntersection(B, m_sampleCases)){
+        sample.addCase(x);
+    }
+    LocalCover sampleCover(&sample);
+    m_sampler->extendCover(sampleCover);
+
+    // FOR: Each rule of the sample, keep it if it is consistent on the full data
+    for(Rule * rule : sampleCover.getRules()){
+        if(subsetEq(rule->getBlock(m_avBlocks), B)){
+            lc.addRule(new Rule(*rule));
+            m_sampleRulesKept++;
+        } else {
+            m_sampleRulesRejected++;
+        }
+        delete rule;
+    }
+    m_sampleCasesCovered += lc.getCoveredConditions(m_avBlocks).size();
+    m_conceptCases += B.size();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    m_sampleSeconds += elapsed.count();
+}
+
+void Algorithm::reportSampling(ostream & stream) const {
+    stream << "Sampled " << m_sampleCases.size() << " cases: kept " << m_sampleRulesKept << " of "
+           << m_sampleRulesKept + m_sampleRulesRejected << " sample rules, covering "
+           << m_sampleCasesCovered << " of " << m_conceptCases << " cases; exact induction covered the other "
+           << m_conceptCases - m_sampleCasesCovered << " (sample phase " << m_sampleSeconds
+           << "s, exact phase " << m_exactSeconds << "s)" << endl;
+}
+
+void Algorithm::setDeadline(chrono::steady_clock::time_point deadline){
+    m_hasDeadline = true;
+    m_deadline = deadline;
+}
+
+bool Algorithm::isPartial() const {
+    return m_deadlineReached;
+}
+
+void Algorithm::reportDeadline(ostream & stream) const {
+    stream << "Deadline reached: partial-quality ruleset; " << m_quickRules
+           << " rules covered single cases, dropConditions skipped for "
+           << m_skippedDropConditions << " rules, dropRules skipped for "
+           << m_skippedDropRules << " concepts" << endl;
+}
+
+void Algorithm::setWarnings(ostream * stream){
+    m_warnings = stream;
+}
+
+void Algorithm::setCheckpoint(Checkpoint * checkpoint){
+    m_checkpoint = checkpoint;
+}
+
+void Algorithm::setSpeculation(size_t seeds, size_t numThreads){
+    m_speculativeSeeds = seeds;
+    m_speculativeThreads = numThreads;
+}
+
+void Algorithm::reportSpeculation(ostream & stream) const {
+    stream << "Speculated " << m_speculativeKept + m_speculativeDiscarded << " rules in "
+           << m_speculativeRounds << " rounds of up to " << m_speculativeSeeds << " seeds: kept "
+           << m_speculativeKept << ", discarded " << m_speculativeDiscarded << " as redundant" << endl;
+}
+
+void Algorithm::setAVBlocks(vector<AV *> avBlocks){
+    m_avBlocks = avBlocks;
+    indexDuplicates();
+}
+
+void Algorithm::setSelection(SelectionStrategy selection){
+    m_selection = selection;
+}
+
+void Algorithm::setSampling(double fraction){
+    m_sampleFraction = fraction;
+}
+
+void Algorithm::setBlockStore(BlockStore * store){
+    m_blockStore = store;
+}
+
+void Algorithm::setRulesetWriter(BinaryRulesetWriter * writer){
+    m_rulesetWriter = writer;
+}
+
+void Algorithm::setWeights(const vector<size_t> * weights){
+    m_weights = weights;
+}
+
+void Algorithm::setInputCases(const vector<size_t> * inputCases){
+    m_inputCases = inputCases;
+}
+
+vector<int> Algorithm::inInputOrder(const set<int> & cases) const {
+    vector<int> ordered(cases.begin(), cases.end());
+    if(m_inputCases){
+        const vector<size_t> & inputCases = *m_inputCases;
+        sort(ordered.begin(), ordered.end(), [&inputCases](int a, int b){
+            return inputCases[a] < inputCases[b];
+        });
+    }
+    return ordered;
+}
+
+vector<AV *> Algorithm::getAVBlocks() const {
+    return m_avBlocks;
+}
+
+LocalCover Algorithm::induceRules(Concept * concept){
+    MemScope memScope(MEM_INDUCTION);
+    TraceSpan span("induceRules", concept->getValue());
     LocalCover lc(concept);
-    size_t numOrigBlocks = m_avBlocks.size();
+    set<int> uncoverable, G;
+
+    // IF: Checkpoint has this concept in progress, continue from its rules
+    if(m_checkpoint && m_checkpoint->resumeProgress(m_conceptIndex, lc, G)){
+        // Cases neither covered nor left in G had been given up on
+        uncoverable = setDifference(setDifference(concept->getBlock(),
+                                                  lc.getCoveredConditions(m_avBlocks)), G);
+    // ELSE IF: Sampling, start from the sample's rules that hold on the full data
+    } else if(m_sampler){
+        seedFromSample(lc);
+    }
+    auto start = chrono::steady_clock::now();
+    uncoverable = extendCover(lc, uncoverable);
+    if(m_sampler){
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        m_exactSeconds += elapsed.count();
+    }
+    if(!uncoverable.empty() && m_warnings){
+        *m_warnings << "Warning: " << uncoverable.size() << " cases of " << concept->labelString()
+                    << " cannot be covered by a consistent rule" << endl;
+    }
+
+    // IF: Out of time, keep every rule
+    if(pastDeadline()){
+        m_skippedDropRules++;
+        if(m_stats){
+            m_stats->count(COUNT_DEADLINE_SKIPPED_DROP_RULES);
+        }
+        return lc;
+    }
+
+    // Remove unnecessary rules
+    ScopedTimer dropTimer(m_stats, PHASE_DROP_RULES);
+    TraceSpan dropSpan("dropRules");
+    size_t dropped = lc.dropRules(m_avBlocks, setDifference(concept->getBlock(), uncoverable));
+    if(m_stats){
+        m_stats->count(COUNT_RULES_DROPPED, dropped);
+    }
+
+    return lc;
+}
+
+set<int> Algorithm::extendCover(LocalCover & lc, set<int> uncoverable){
+    // IF: Speculating, build several rules per round instead
+    if(m_speculativeSeeds > 1){
+        return extendCoverSpeculative(lc, uncoverable);
+    }
+    MemScope memScope(MEM_INDUCTION);
+    set<int> B = lc.getConcept()->getBlock();
+    set<int> G = setDifference(setDifference(B, uncoverable), lc.getCoveredConditions(m_avBlocks));
 
     // WHILE: G is non-empty
     while(!G.empty()){
+        // IF: Out of time, cover the rest of G quickly instead
+        if(pastDeadline()){
+            uncoverable = setUnion(uncoverable, coverQuickly(lc, G, B));
+            break;
+        }
         Rule rule;
-        map<int, set<int>> T_G;
+        ScopedTimer selectionTimer(m_stats, PHASE_SELECTION);
+        TraceSpan selectionSpan("selectConditions");
 
         #if DEBUG == true
             printSet("G = ", G);
         #endif
 
-        // FOR: All attribute-value blocks
-        for(unsigned i = 0; i < numOrigBlocks; i++){
-            set<int> intersectSet = setIntersection(m_avBlocks[i]->getBlock(), G);
-            // IF: Intersection is non-empty
-            if(!(intersectSet.empty())){
-                T_G[i] = intersectSet;
-            }        
-        }
-        
         // Select conditions for rule
-        // WHILE: T is non-empty or T is not subsetEq to B
-        while( (rule.empty()) || !(subsetEq(rule.getBlock(m_avBlocks), B)) ){
-            int choicePos = getOptimalCondition(T_G);
-            rule.addCondition(choicePos);
-            T_G.erase(choicePos);
-                        
-            // Update goal set
-            G = setIntersection(m_avBlocks[choicePos]->getBlock(), G);
-
-            // FOR: Relevant attribute-value block intersections
-            for(auto const & [i, intersect] : T_G){
-                T_G[i] = setIntersection(m_avBlocks[i]->getBlock(), G);
-            }
-        } // END WHILE (INNER LOOP)
-
-        // Remove unnecessary conditions
+        bool consistent = m_selection == SELECT_BOUNDED ? selectConditionsBounded(rule, G, B)
+                                                        : selectConditions(rule, G, B);
+        selectionTimer.stop();
+        selectionSpan.end();
+
+        // IF: No block still intersects G, the cases left in G match every
+        //     block a case of another concept matches; give up on them
+        if(!consistent){
+            uncoverable = setUnion(uncoverable, G);
+            G = setDifference(setDifference(B, uncoverable), lc.getCoveredConditions(m_avBlocks));
+            if(m_checkpoint){
+                m_checkpoint->progress(m_conceptIndex, lc, G);
+            }
+            continue;
+        }
+
+        // Remove unnecessary conditions, unless out of time
         // rule.mergeIntervals(m_avBlocks);
-        rule.dropConditions(m_avBlocks, B);
+        if(pastDeadline()){
+            m_skippedDropConditions++;
+            if(m_stats){
+                m_stats->count(COUNT_DEADLINE_SKIPPED_DROP_CONDITIONS);
+            }
+        } else {
+            ScopedTimer dropTimer(m_stats, PHASE_DROP_CONDITIONS);
+            TraceSpan dropSpan("dropConditions");
+            size_t dropped = rule.dropConditions(m_avBlocks, B);
+            if(m_stats){
+                m_stats->count(COUNT_CONDITIONS_DROPPED, dropped);
+            }
+        }
 
         // Add to local covering
-        lc.addRule(new Rule(rule));
+        {
+            MemScope coverScope(MEM_COVERS);
+            lc.addRule(new Rule(rule));
+        }
+        if(m_stats){
+            m_stats->count(COUNT_RULES_INDUCED);
+        }
         
         // Update goal set
-        G = setDifference(B, lc.getCoveredConditions(m_avBlocks));
+        G = setDifference(setDifference(B, uncoverable), lc.getCoveredConditions(m_avBlocks));
+        if(m_checkpoint){
+            m_checkpoint->progress(m_conceptIndex, lc, G);
+        }
     } // END WHILE (OUTER LOOP)
+    return uncoverable;
+}
 
-    // Remove unnecessary rules
-    lc.dropRules(m_avBlocks, B);
+set<int> Algorithm::extendCoverSpeculative(LocalCover & lc, set<int> uncoverable){
+    MemScope memScope(MEM_INDUCTION);
+    set<int> B = lc.getConcept()->getBlock();
+    set<int> G = setDifference(setDifference(B, uncoverable), lc.getCoveredConditions(m_avBlocks));
+    if(!m_speculativePool){
+        m_speculativePool = make_shared<ThreadPool>(m_speculativeThreads);
+    }
+    ThreadPool & pool = *m_speculativePool;
 
-    return lc;
+    // Each seed gets its own selector over the shared, read-only blocks;
+    // statistics are not thread-safe, so they only keep them here
+    vector<Algorithm> selectors(m_speculativeSeeds, Algorithm(m_numAttributes));
+    for(Algorithm & selector : selectors){
+        selector.m_avBlocks = m_avBlocks;
+        selector.m_canonical = m_canonical;
+        selector.m_duplicates = m_duplicates;
+        selector.m_weights = m_weights;
+        selector.m_selection = m_selection;
+    }
+
+    // WHILE: G is non-empty
+    while(!G.empty()){
+        // IF: Out of time, cover the rest of G quickly instead
+        if(pastDeadline()){
+            uncoverable = setUnion(uncoverable, coverQuickly(lc, G, B));
+            break;
+        }
+        size_t numSeeds = min(m_speculativeSeeds, G.size());
+        vector<set<int>> seeds(numSeeds);
+        vector<Rule> rules(numSeeds);
+        vector<char> consistent(numSeeds, 0);
+        vector<size_t> dropped(numSeeds, 0);
+
+        // Split G into contiguous runs of cases, so the seeds do not depend on timing
+        size_t position = 0;
+        for(int x : inInputOrder(G)){
+            set<int> & seed = seeds[position++ * numSeeds / G.size()];
+            seed.insert(seed.end(), x);
+        }
+
+        ScopedTimer selectionTimer(m_stats, PHASE_SELECTION);
+        TraceSpan roundSpan("speculate", to_string(numSeeds));
+        // FOR: Each seed, select and drop conditions for its rule on the pool
+        for(size_t s = 0; s < numSeeds; s++){
+            pool.submit([this, s, &selectors, &seeds, &rules, &consistent, &dropped, &B](){
+                TraceSpan span("selectConditions");
+                Algorithm & selector = selectors[s];
+                consistent[s] = m_selection == SELECT_BOUNDED
+                                    ? selector.selectConditionsBounded(rules[s], seeds[s], B)
+                                    : selector.selectConditions(rules[s], seeds[s], B);
+                if(consistent[s]){
+                    dropped[s] = rules[s].dropConditions(m_avBlocks, B);
+                }
+            });
+        }
+        pool.wait();
+        selectionTimer.stop();
+        roundSpan.end();
+        m_speculativeRounds++;
+
+        // FOR: Each seed in order, add its rule if it still covers part of G
+        set<int> stuck;
+        for(size_t s = 0; s < numSeeds; s++){
+            // IF: Seed ran out of blocks, what was left of it may be uncoverable
+            if(!consistent[s]){
+                stuck = setUnion(stuck, seeds[s]);
+                continue;
+            }
+            set<int> covered = setIntersection(rules[s].getBlock(m_avBlocks), G);
+            if(covered.empty()){
+                m_speculativeDiscarded++;
+                if(m_stats){
+                    m_stats->count(COUNT_SPECULATIVE_DISCARDED);
+                }
+                continue;
+            }
+            {
+                MemScope coverScope(MEM_COVERS);
+                lc.addRule(new Rule(rules[s]));
+            }
+            G = setDifference(G, covered);
+            m_speculativeKept++;
+            if(m_stats){
+                m_stats->count(COUNT_RULES_INDUCED);
+                m_stats->count(COUNT_SPECULATIVE_RULES);
+                m_stats->count(COUNT_CONDITIONS_DROPPED, dropped[s]);
+            }
+        }
+
+        // Cases a rule of another seed covered are not uncoverable after all
+        uncoverable = setUnion(uncoverable, setIntersection(stuck, G));
+
+        // Update goal set
+        G = setDifference(setDifference(B, uncoverable), lc.getCoveredConditions(m_avBlocks));
+        if(m_checkpoint){
+            m_checkpoint->progress(m_conceptIndex, lc, G);
+        }
+    }
+    return uncoverable;
+}
+
+bool Algorithm::pastDeadline(){
+    if(m_hasDeadline && !m_deadlineReached && chrono::steady_clock::now() >= m_deadline){
+        m_deadlineReached = true;
+        // Rules saved from now on are partial quality, and so is a run resuming them
+        if(m_checkpoint){
+            m_checkpoint->setPartial();
+        }
+    }
+    return m_deadlineReached;
+}
+
+set<int> Algorithm::coverQuickly(LocalCover & lc, set<int> G, const set<int> & B){
+    TraceSpan span("coverQuickly", to_string(G.size()));
+    set<int> uncoverable;
+
+    // Candidate blocks smallest first, ties by index
+    vector<int> order;
+    for(unsigned i = 0; i < m_avBlocks.size(); i++){
+        if(m_canonical[i] == (int) i){
+            order.push_back(i);
+        }
+    }
+    vector<size_t> sizes(m_avBlocks.size());
+    for(int i : order){
+        sizes[i] = m_avBlocks[i]->size();
+    }
+    stable_sort(order.begin(), order.end(), [&sizes](int a, int b){
+        return sizes[a] < sizes[b];
+    });
+
+    // Blocks containing each case of G, in that order, from one intersection per block
+    map<int, vector<int>> containing;
+    for(int i : order){
+        for(int x : m_avBlocks[i]->intersect(G)){
+            containing[x].push_back(i);
+        }
+    }
+
+    // WHILE: G is non-empty, build a rule for its first case
+    while(!G.empty()){
+        int x = *G.begin();
+        if(m_inputCases){
+            const vector<size_t> & inputCases = *m_inputCases;
+            x = *min_element(G.begin(), G.end(), [&inputCases](int a, int b){
+                return inputCases[a] < inputCases[b];
+            });
+        }
+        Rule rule;
+        set<int> block;
+        // FOR: Each block containing the case, add it if it narrows the rule
+        for(int i : containing[x]){
+            set<int> narrowed = rule.empty() ? m_avBlocks[i]->getBlock() : m_avBlocks[i]->intersect(block);
+            if(rule.empty() || narrowed.size() < block.size()){
+                rule.addCondition(i);
+                block = narrowed;
+            }
+            if(subsetEq(block, B)){
+                break;
+            }
+        }
+        // IF: Even every block together holds a case of another concept
+        if(rule.empty() || !subsetEq(block, B)){
+            uncoverable.insert(x);
+            G.erase(x);
+            continue;
+        }
+        {
+            MemScope coverScope(MEM_COVERS);
+            lc.addRule(new Rule(rule));
+        }
+        m_quickRules++;
+        if(m_stats){
+            m_stats->count(COUNT_RULES_INDUCED);
+            m_stats->count(COUNT_DEADLINE_QUICK_RULES);
+        }
+        G = setDifference(G, block);
+    }
+    return uncoverable;
+}
+
+bool Algorithm::selectConditions(Rule & rule, set<int> & G, const set<int> & B){
+    map<int, set<int>> T_G;
+    size_t numOrigBlocks = m_avBlocks.size();
+
+    // FOR: All attribute-value blocks, except later copies of identical blocks
+    for(unsigned i = 0; i < numOrigBlocks; i++){
+        if(m_canonical[i] != (int) i){
+            continue;
+        }
+        set<int> intersectSet = m_avBlocks[i]->intersect(G);
+        // IF: Intersection is non-empty
+        if(!(intersectSet.empty())){
+            T_G[i] = intersectSet;
+        }        
+    }
+    if(m_stats){
+        m_stats->count(COUNT_INTERSECTIONS, numOrigBlocks);
+    }
+    
+    // WHILE: T is non-empty or T is not subsetEq to B
+    while( (rule.empty()) || !(subsetEq(rule.getBlock(m_avBlocks), B)) ){
+        // IF: No block still intersects G, the rule cannot become consistent
+        if(T_G.empty()){
+            return false;
+        }
+        if(m_stats){
+            m_stats->recordSelection(T_G.size());
+            m_stats->count(COUNT_INNER_ITERATIONS);
+            m_stats->count(COUNT_INTERSECTIONS, T_G.size());
+        }
+        int choicePos = getOptimalCondition(T_G);
+        rule.addCondition(choicePos);
+        T_G.erase(choicePos);
+
+        // Update goal set
+        G = m_avBlocks[choicePos]->intersect(G);
+
+        // FOR: Candidates still intersecting G; G only shrinks, so others never return
+        for(auto it = T_G.begin(); it != T_G.end(); ){
+            it->second = m_avBlocks[it->first]->intersect(G);
+            it = it->second.empty() ? T_G.erase(it) : next(it);
+        }
+
+        // IF: Block has identical copies, they become candidates now, holding all of G
+        auto copies = m_duplicates.find(choicePos);
+        if(copies != m_duplicates.end() && !G.empty()){
+            for(int d : copies->second){
+                T_G[d] = G;
+            }
+        }
+    } // END WHILE (INNER LOOP)
+    return true;
+}
+
+bool Algorithm::selectConditionsBounded(Rule & rule, set<int> & G, const set<int> & B){
+    // Candidates keyed by an upper bound on |block ∩ G|. G only shrinks,
+    // so a count stays a valid bound for the rest of the rule.
+    priority_queue<pair<size_t, int>> bounds;
+    size_t sizeG = weightedSize(G, m_weights);
+    for(unsigned i = 0; i < m_avBlocks.size(); i++){
+        if(m_canonical[i] == (int) i && m_avBlocks[i]->size() > 0){
+            bounds.push(make_pair(m_weights ? sizeG : min(m_avBlocks[i]->size(), sizeG), i));
+        }
+    }
+
+    // WHILE: T is non-empty or T is not subsetEq to B
+    while( (rule.empty()) || !(subsetEq(rule.getBlock(m_avBlocks), B)) ){
+        size_t maxSize = 0, evaluated = 0;
+        list<int> maxSizePos;
+        vector<pair<size_t, int>> counted;
+
+        // WHILE: Best bound could still beat or tie the best exact count, count it
+        while(!bounds.empty() && bounds.top().first > 0 && bounds.top().first >= maxSize){
+            int i = bounds.top().second;
+            bounds.pop();
+            size_t size = m_avBlocks[i]->intersectCount(G, m_weights);
+            counted.push_back(make_pair(size, i));
+            evaluated++;
+            if(size > maxSize){
+                maxSize = size;
+                maxSizePos.clear();
+                maxSizePos.push_back(i);
+            } else if(size == maxSize && size > 0){
+                maxSizePos.push_back(i);
+            }
+        }
+        if(m_stats){
+            m_stats->recordSelection(evaluated);
+            m_stats->count(COUNT_INNER_ITERATIONS);
+            m_stats->count(COUNT_INTERSECTIONS, evaluated);
+        }
+        // IF: No block still intersects G, the rule cannot become consistent
+        if(maxSize == 0){
+            return false;
+        }
+
+        // Same tie-break as getOptimalCondition: smallest block, then first index
+        int choicePos = -1;
+        size_t minCard = 0;
+        for(int i : maxSizePos){
+            size_t card = m_weights ? weightedSize(m_avBlocks[i]->getBlock(), m_weights)
+                                    : m_avBlocks[i]->size();
+            if(choicePos < 0 || card < minCard || (card == minCard && i < choicePos)){
+                choicePos = i;
+                minCard = card;
+            }
+        }
+        rule.addCondition(choicePos);
+
+        // Counted candidates go back with their exact count as the new bound
+        for(auto const & [size, i] : counted){
+            if(i != choicePos && size > 0){
+                bounds.push(make_pair(size, i));
+            }
+        }
+
+        // Update goal set
+        G = m_avBlocks[choicePos]->intersect(G);
+
+        // IF: Block has identical copies, they become candidates now
+        auto copies = m_duplicates.find(choicePos);
+        if(copies != m_duplicates.end()){
+            for(int d : copies->second){
+                bounds.push(make_pair(weightedSize(G, m_weights), d));
+            }
+        }
+    } // END WHILE (INNER LOOP)
+    return true;
+}
+
+void Algorithm::indexDuplicates(){
+    m_canonical.assign(m_avBlocks.size(), 0);
+    m_duplicates.clear();
+    map<uint64_t, vector<int>> byHash;
+    size_t numDuplicates = 0;
+
+    // FOR: Each block, find an earlier block with the same hash and case set
+    for(unsigned i = 0; i < m_avBlocks.size(); i++){
+        uint64_t hash = m_avBlocks[i]->contentHash();
+        m_canonical[i] = i;
+        vector<int> & bucket = byHash[hash];
+        for(int c : bucket){
+            if(m_avBlocks[c]->size() == m_avBlocks[i]->size()
+               && m_avBlocks[c]->getBlock() == m_avBlocks[i]->getBlock()){
+                m_canonical[i] = c;
+                m_duplicates[c].push_back(i);
+                numDuplicates++;
+                break;
+            }
+        }
+        if(m_canonical[i] == (int) i){
+            bucket.push_back(i);
+        }
+    }
+    if(m_stats){
+        m_stats->count(COUNT_DUPLICATE_BLOCKS, numDuplicates);
+    }
 }
 
 int Algorithm::getOptimalCondition(map<int, set<int>> T_G){
@@ -177,13 +860,14 @@ int Algorithm::getOptimalCondition(map<int, set<int>> T_G){
     size_t maxSize = 0, minCard = INT_MAX;
 
     for(auto const & [i, intersect] : T_G){
+        size_t size = weightedSize(intersect, m_weights);
         // IF: Current size is larger than maxSize, clear list and add index
-        if(T_G[i].size() > maxSize){
-            maxSize = T_G[i].size();
+        if(size > maxSize){
+            maxSize = size;
             maxSizePos.clear();
             maxSizePos.push_back(i);
         // IF: Current size is equal to maxSize, add index for consideration
-        } else if (T_G[i].size() == maxSize){
+        } else if (size == maxSize){
             maxSizePos.push_back(i);
         }
     }
@@ -198,12 +882,14 @@ int Algorithm::getOptimalCondition(map<int, set<int>> T_G){
         // IF: Set is non-empty
         if(!(T_G[i].empty())){
             // IF: Current cardinality is smaller than minCard, update minCard
-            if(m_avBlocks[i]->size() < minCard){
-                minCard = m_avBlocks[i]->size();
+            size_t card = m_weights ? weightedSize(m_avBlocks[i]->getBlock(), m_weights)
+                                    : m_avBlocks[i]->size();
+            if(card < minCard){
+                minCard = card;
                 minCardPos.clear();
                 minCardPos.push_back(i);
             // IF: Current size is equal to minCard, cardinality is not unique
-            } else if (m_avBlocks[i]->size() == minCard){
+            } else if (card == minCard){
                 minCardPos.push_back(i);
             }
         }
@@ -12,20 +12,36 @@
 #define ALGORITHM_H
 #include "avNumeric.hpp"
 #include "avSymbolic.hpp"
+#include "binaryRuleset.hpp"
+#include "blockStore.hpp"
+#include "checkpoint.hpp"
 #include "dataset.hpp"
 #include "localCover.hpp"
+#include "memTracker.hpp"
+#include "options.hpp"
+#include "stats.hpp"
+#include "threadPool.hpp"
+#include "trace.hpp"
 #include "utils.hpp"
+#include <chrono>
+#include <map>
+#include <memory>
 #include <set>
 #include <vector>
 #define DEBUG false
 
 class Algorithm {
 public:
-    Algorithm(std::size_t numAttributes);
+    Algorithm(std::size_t numAttributes, Stats * stats = nullptr);
 
     /* Generate attribute-value blocks for dataset. 
+       @param cases, if given, blocks (and cutpoints) only use these cases.
        @post m_avBlocks is initialized and populated. */
-    void generateAVBlocks(Dataset * data);
+    void generateAVBlocks(Dataset * data, const std::set<int> * cases = nullptr);
+
+    /* Selects the cutpoints used by generateAVBlocks (default: CUT_ALL).
+       @param maxCutpoints, cap per attribute for CUT_QUANTILE. */
+    void setCutpointMode(CutpointMode mode, std::size_t maxCutpoints = 256);
 
     /* Generate concept blocks for dataset. */
     std::vector<Concept *> generateConcepts(Dataset * data);
@@ -33,14 +49,214 @@ public:
     /* Creates string with all rules in (a, v) -> (d, v) format. */
     void generateRuleset(ostream & file, Dataset * data);
 
+    /* Same as generateRuleset, but uses the current attribute-value blocks. */
+    void generateRules(ostream & file, Dataset * data);
+
+    /* Same as generateRules, but for concepts built elsewhere (e.g. loaded
+       from a snapshot); they are deleted once their rules are written. */
+    void generateRules(ostream & file, std::vector<Concept *> concepts);
+
+    /* Uses blocks generated elsewhere (e.g. cached); they are only read. */
+    void setAVBlocks(std::vector<AV *> avBlocks);
+
+    /* Selects how conditions are chosen (default: SELECT_FULL). */
+    void setSelection(SelectionStrategy selection);
+
+    /* Keeps blocks built by generateAVBlocks in a block store instead
+       of in memory; null (the default) for none. */
+    void setBlockStore(BlockStore * store);
+
+    /* Makes induceRules start from rules induced on a stratified sample of
+       this fraction of each concept, keeping those consistent on the full
+       data; 0 (the default) induces on the full data only. */
+    void setSampling(double fraction);
+
+    /* Prints what the sample phase contributed to the last generateRules. */
+    void reportSampling(std::ostream & stream) const;
+
+    /* Makes extendCover build rules from up to this many seeds of G at
+       once, on a pool of numThreads threads (0 is one per core), and
+       accept them in seed order, skipping any that cover nothing still
+       in G; 0 or 1 (the default) builds one rule at a time. Rules can
+       differ from the sequential ones; blocks must be in memory. */
+    void setSpeculation(std::size_t seeds, std::size_t numThreads = 0);
+
+    /* Prints how many speculative rules the last generateRules kept. */
+    void reportSpeculation(std::ostream & stream) const;
+
+    /* Records finished coverings and the one in progress in a checkpoint,
+       and resumes from what it loaded; null (the default) for none. */
+    void setCheckpoint(Checkpoint * checkpoint);
+
+    /* Makes induction anytime: once this point passes, extendCover stops
+       selecting conditions and covers the rest of G with one quick rule
+       per case, and dropConditions and dropRules are skipped. */
+    void setDeadline(std::chrono::steady_clock::time_point deadline);
+
+    /* Checks if the deadline cut the last generateRules short, so its
+       rules are valid but of lower quality than a full run's. */
+    bool isPartial() const;
+
+    /* Prints which phases the deadline cut short. */
+    void reportDeadline(std::ostream & stream) const;
+
+    /* Also hands every induced covering to a binary writer; null for none. */
+    void setRulesetWriter(BinaryRulesetWriter * writer);
+
+    /* Sends warnings (e.g. cases no consistent rule covers) to a stream
+       (default: cerr); null discards them. */
+    void setWarnings(std::ostream * stream);
+
+    /* Weights case counts by multiplicity (see Dataset::collapseDuplicates)
+       when choosing conditions and classifying rules; null for none. */
+    void setWeights(const std::vector<std::size_t> * weights);
+
+    /* Makes the choices that follow case order (which cases are sampled,
+       how G is split into speculative seeds, which case a quick rule is
+       built for) follow the order before renumbering, so they do not
+       change with it; null (the default) when cases were not renumbered. */
+    void setInputCases(const std::vector<std::size_t> * inputCases);
+
+    /* Gets the attribute-value blocks. */
+    std::vector<AV *> getAVBlocks() const;
+
     /* Generate ruleset using MLEM2. */
     LocalCover induceRules(Concept * concept);
 
+    /* Adds MLEM2 rules to a covering until it covers its whole concept.
+       Rules already in the covering are kept and not dropped.
+       @param uncoverable, cases already given up on (e.g. when resuming).
+       @returns Cases no consistent rule can cover, because every block
+                containing them also contains a case of another concept
+                (only possible when discretization merges values, e.g.
+                with CUT_QUANTILE); empty for consistent data. */
+    std::set<int> extendCover(LocalCover & lc, std::set<int> uncoverable = std::set<int>());
+
     /* Finds the position of the best attribute-value pair. */
     int getOptimalCondition(map<int, set<int>> T_G);
 
 private:
     std::size_t m_numAttributes;
     std::vector<AV *> m_avBlocks;
+    CutpointMode m_cutpointMode;
+    std::size_t m_maxCutpoints;
+    SelectionStrategy m_selection;
+
+    /* Index of the first block with the same case set, for every block. */
+    std::vector<int> m_canonical;
+
+    /* Later blocks with the same case set as a canonical block. */
+    std::map<int, std::vector<int>> m_duplicates;
+
+    /* Multiplicity of each case; nullptr when every case counts once. */
+    const std::vector<std::size_t> * m_weights;
+
+    /* Number of each case before renumbering; nullptr when not renumbered. */
+    const std::vector<std::size_t> * m_inputCases;
+
+    /* Out-of-core storage for built blocks; nullptr keeps them in memory. */
+    BlockStore * m_blockStore;
+
+    /* Fraction of each concept sampled first; 0 when not sampling. */
+    double m_sampleFraction;
+
+    /* Induces on the sample's blocks while generateRules runs; else nullptr. */
+    Algorithm * m_sampler;
+    std::vector<AV *> m_sampleBlocks;
+    std::set<int> m_sampleCases;
+
+    /* Totals of the sample phase, for reportSampling. */
+    std::size_t m_sampleRulesKept;
+    std::size_t m_sampleRulesRejected;
+    std::size_t m_sampleCasesCovered;
+    std::size_t m_conceptCases;
+    double m_sampleSeconds;
+    double m_exactSeconds;
+
+    /* Seeds per round of speculative induction; 0 or 1 when not speculating. */
+    std::size_t m_speculativeSeeds;
+    std::size_t m_speculativeThreads;
+
+    /* Threads seeds are built on, started at the first speculative round
+       and kept for every later concept; nullptr until then. */
+    std::shared_ptr<ThreadPool> m_speculativePool;
+
+    /* Totals of speculative induction, for reportSpeculation. */
+    std::size_t m_speculativeRounds;
+    std::size_t m_speculativeKept;
+    std::size_t m_speculativeDiscarded;
+
+    /* When induction must stop refining; only used if m_hasDeadline. */
+    bool m_hasDeadline;
+    std::chrono::steady_clock::time_point m_deadline;
+
+    /* What the deadline cut short, for reportDeadline. */
+    bool m_deadlineReached;
+    std::size_t m_quickRules;
+    std::size_t m_skippedDropConditions;
+    std::size_t m_skippedDropRules;
+
+    /* Saves progress and holds what was resumed; nullptr when disabled. */
+    Checkpoint * m_checkpoint;
+
+    /* Position of the concept being induced by generateRules. */
+    std::size_t m_conceptIndex;
+
+    /* Receives each covering as it is induced; nullptr when disabled. */
+    BinaryRulesetWriter * m_rulesetWriter;
+
+    /* Run statistics; nullptr when disabled. */
+    Stats * m_stats;
+
+    /* Receives warnings; nullptr discards them. */
+    std::ostream * m_warnings;
+
+    /* extendCover HELPER: Adds conditions to the rule until it is consistent,
+       recomputing every candidate's intersection with G on each step.
+       @returns False if no block intersects G before the rule is consistent. */
+    bool selectConditions(Rule & rule, std::set<int> & G, const std::set<int> & B);
+
+    /* extendCover HELPER: Same choices as selectConditions, but candidates are
+       kept in a heap by an upper bound on their intersection with G (their
+       last count) and only counted while the bound can reach the best count. */
+    bool selectConditionsBounded(Rule & rule, std::set<int> & G, const std::set<int> & B);
+
+    /* extendCover HELPER: Builds one rule per seed of G concurrently, then
+       adds them in seed order while they still cover part of G.
+       @returns Same as extendCover. */
+    std::set<int> extendCoverSpeculative(LocalCover & lc, std::set<int> uncoverable);
+
+    /* Gets cases in the order they had before renumbering. */
+    std::vector<int> inInputOrder(const std::set<int> & cases) const;
+
+    /* Checks the clock against the deadline, noting when it has passed. */
+    bool pastDeadline();
+
+    /* extendCover HELPER: Covers G with one rule per case: the blocks
+       containing the case, smallest first, while they narrow the rule,
+       until it is consistent.
+       @returns Cases of G no consistent rule can cover. */
+    std::set<int> coverQuickly(LocalCover & lc, std::set<int> G, const std::set<int> & B);
+
+    /* Groups blocks with identical case sets (by content hash, then
+       comparison). Only the first block of a group is a candidate until it
+       is selected; then the others join T_G, as they would have tied with
+       it on every count and lost on index until then. */
+    void indexDuplicates();
+
+    /* generateRules HELPER: Picks every (1 / m_sampleFraction)-th case of each
+       concept (at least one) and sets up m_sampler on blocks cut down to them. */
+    void prepareSample(const std::vector<Concept *> & concepts);
+
+    /* generateRules HELPER: Frees the sample's blocks and m_sampler. */
+    void finishSample();
+
+    /* induceRules HELPER: Induces rules on the sample of a concept and adds
+       the ones whose full-data block lies within the concept. */
+    void seedFromSample(LocalCover & lc);
+
+    /* generateAVBlocks HELPER: Writes a block's cases to the block store.
+       @returns False if the row could not be written; the block is empty. */
+    bool storeBlock(Dataset * data, int i, const std::set<int> * cases);
 };
 #endif
\ No newline at end of file
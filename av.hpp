@@ -9,17 +9,21 @@
 
 #ifndef AV_H
 #define AV_H
+#include "blockStore.hpp"
+#include "utils.hpp"
 #include "value.hpp"
+#include <cstdint>
 #include <string>
 #include <set>
+#include <vector>
 
 using namespace std;
 
 class AV {
 public:
-    AV(){}
+    AV() : m_store(nullptr), m_row(0) {}
     AV(string attr, int attrCol) 
-        : m_attr(attr), m_attrCol(attrCol) { }
+        : m_attr(attr), m_attrCol(attrCol), m_store(nullptr), m_row(0) { }
     virtual ~AV(){}
 
     virtual int getMinValue() const { return -1; }
@@ -32,12 +36,47 @@ public:
 
     /* Gets the block set. */
     virtual set<int> getBlock() const {
-        return m_block;
+        return m_store ? m_store->cases(m_row) : m_block;
     }
     
     /* Gets the size of the block set. */
     virtual size_t size() const {
-        return m_block.size();
+        return m_store ? m_store->count(m_row) : m_block.size();
+    }
+
+    /* Gets the cases of a set that are in the block; unlike intersecting
+       with getBlock, a stored block is only read where the set has cases. */
+    virtual set<int> intersect(const set<int> & other) const {
+        return m_store ? m_store->intersect(m_row, other) : setIntersection(m_block, other);
+    }
+
+    /* Gets the FNV-1a hash of the block's cases, in increasing order. */
+    virtual uint64_t contentHash() const {
+        if(m_store){
+            return m_store->hash(m_row);
+        }
+        uint64_t hash = 14695981039346656037ULL;
+        for(int x : m_block){
+            hash = (hash ^ (uint64_t) x) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    /* Counts the cases of a set that are in the block, without building
+       the intersection; weighted by multiplicity if weights are given. */
+    virtual size_t intersectCount(const set<int> & other, const vector<size_t> * weights = nullptr) const {
+        if(m_store){
+            return m_store->intersectCount(m_row, other, weights);
+        }
+        const set<int> & small = other.size() < m_block.size() ? other : m_block;
+        const set<int> & large = other.size() < m_block.size() ? m_block : other;
+        size_t count = 0;
+        for(int x : small){
+            if(large.count(x)){
+                count += weights ? (*weights)[x] : 1;
+            }
+        }
+        return count;
     }
 
     /* Returns the column number of the attribute */
@@ -47,11 +86,32 @@ public:
 
     virtual void setBlock(set<int> block) {
         m_block = block;
+        m_store = nullptr;
+    }
+
+    /* Moves the case set to a row of a block store; the store must
+       outlive the block and its copies. */
+    virtual void setStoreRow(BlockStore * store, size_t row) {
+        m_block.clear();
+        m_store = store;
+        m_row = row;
     }
     
-    /* TEMPLATE: Adds if value of block and specified case match.
+    /* Adds if value of block and specified case match.
        @returns True if add is successful; False, otherwise. */
-    virtual bool addOnMatch(Value * value, int x) = 0;
+    virtual bool addOnMatch(Value * value, int x){
+        if(matches(value)){
+            m_block.insert(x);
+            return true;
+        }
+        return false;
+    }
+
+    /* TEMPLATE: Checks if a value satisfies the block's condition. */
+    virtual bool matches(Value * value) const = 0;
+
+    /* TEMPLATE: Copies the block, including its case set. */
+    virtual AV * clone() const = 0;
 
     /* TEMPLATE: Checks if block is numeric or symbolic. */
     virtual bool isNumeric() const = 0;
@@ -67,5 +127,7 @@ protected:
     int m_attrCol;
     string m_value;
     set<int> m_block;
+    BlockStore * m_store;
+    size_t m_row;
 };
 #endif
@@ -31,12 +31,25 @@ public:
     int getMaxValue() const {
         return m_maxValue;
     }
-    bool addOnMatch(Value * value, int x){
-        if(value->getNumValue() >= m_minValue && value->getNumValue() <= m_maxValue){
-            m_block.insert(x);
-            return true;
-        }
-        return false;
+
+    /* Gets the exact interval bounds. */
+    float getLowerBound() const {
+        return m_minValue;
+    }
+    float getUpperBound() const {
+        return m_maxValue;
+    }
+
+    /* Moves the interval; the case set is not updated. */
+    void setBounds(float minValue, float maxValue){
+        m_minValue = minValue;
+        m_maxValue = maxValue;
+    }
+    bool matches(Value * value) const {
+        return value->getNumValue() >= m_minValue && value->getNumValue() <= m_maxValue;
+    }
+    AV * clone() const {
+        return new AVNumeric(*this);
     }
     bool isNumeric() const {
         return true;
@@ -21,12 +21,16 @@ public:
         : AV(attr, attrCol) {
         m_value = value;
     }
-    bool addOnMatch(Value * value, int x){
-        if(m_value.compare(value->getStrValue()) == 0){
-            m_block.insert(x);
-            return true;
-        }
-        return false;
+
+    /* Gets the symbolic value of the block. */
+    string getValue() const {
+        return m_value;
+    }
+    bool matches(Value * value) const {
+        return m_value.compare(value->getStrValue()) == 0;
+    }
+    AV * clone() const {
+        return new AVSymbolic(*this);
     }
     bool isNumeric() const {
         return false;
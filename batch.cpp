@@ -0,0 +1,116 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the batch class.
+    @file batch.cpp
+
+    This class runs many induction jobs
+    (input/output file pairs) in one process
+    on a shared worker pool. */
+
+#include "batch.hpp"
+#include "executive.hpp"
+#include "threadPool.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+using namespace std;
+
+void Batch::addJob(string inFile, string outFile){
+    m_jobs.push_back({inFile, outFile, false, "not run", 0});
+}
+
+bool Batch::loadManifest(string filename){
+    ifstream file(filename);
+
+    // Unable to open file; Signal with boolean
+    if(!file){
+        return false;
+    }
+
+    string line;
+    // WHILE: Lines remain in the manifest
+    while(getline(file, line)){
+        size_t pos = line.find('!');
+        if(pos != string::npos){
+            line.erase(pos);
+        }
+        istringstream buffer(line);
+        string inFile, outFile;
+        // IF: Line holds a pair
+        if(buffer >> inFile >> outFile){
+            addJob(inFile, outFile);
+        } else if(!inFile.empty()){
+            cerr << "Ignoring manifest line without output file: " << inFile << endl;
+        }
+    }
+    return true;
+}
+
+size_t Batch::run(size_t numThreads, Stats * stats){
+    vector<unique_ptr<Stats>> jobStats(m_jobs.size());
+    {
+        ThreadPool pool(numThreads);
+        for(unsigned i = 0; i < m_jobs.size(); i++){
+            if(stats){
+                jobStats[i].reset(new Stats());
+            }
+            pool.submit([this, i, &jobStats]{ runJob(m_jobs[i], jobStats[i].get()); });
+        }
+        pool.wait();
+    }
+
+    size_t failed = 0;
+    for(unsigned i = 0; i < m_jobs.size(); i++){
+        if(!m_jobs[i].success){
+            failed++;
+        }
+        if(stats){
+            stats->merge(*jobStats[i], m_jobs[i].inFile + ": ");
+        }
+    }
+    return failed;
+}
+
+void Batch::printStatus(ostream & stream) const {
+    for(const Job & job : m_jobs){
+        if(job.success){
+            stream << "ok\t" << job.inFile << " -> " << job.outFile << "\t" << job.seconds << "s" << endl;
+        } else {
+            stream << "FAILED\t" << job.inFile << " -> " << job.outFile << "\t" << job.error << endl;
+        }
+    }
+}
+
+void Batch::setResultCache(ResultCache * cache){
+    m_resultCache = cache;
+}
+
+size_t Batch::size() const {
+    return m_jobs.size();
+}
+
+void Batch::runJob(Job & job, Stats * stats){
+    auto start = chrono::steady_clock::now();
+    Executive exec;
+    exec.setStats(stats);
+    exec.setOptions(m_options);
+    exec.setResultCache(m_resultCache);
+
+    if(!exec.parseInFile(job.inFile)){
+        job.error = "unable to read input file";
+    } else if(!exec.generateOutFile(job.outFile)){
+        job.error = exec.getLastError().empty() ? "unable to write output file" : exec.getLastError();
+    } else if(!exec.getLastError().empty()){
+        job.error = exec.getLastError();
+    } else {
+        job.success = true;
+        job.error.clear();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    job.seconds = elapsed.count();
+}
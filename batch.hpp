@@ -0,0 +1,64 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the batch class.
+    @file batch.hpp
+
+    This class runs many induction jobs
+    (input/output file pairs) in one process
+    on a shared worker pool. */
+
+#ifndef BATCH_H
+#define BATCH_H
+#include "options.hpp"
+#include "resultCache.hpp"
+#include "stats.hpp"
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct Job {
+    std::string inFile;
+    std::string outFile;
+    bool success;
+    std::string error;
+    double seconds;
+};
+
+class Batch {
+public:
+    Batch(const Options & options = Options())
+        : m_options(options), m_resultCache(nullptr) { }
+
+    /* Adds a single job. */
+    void addJob(std::string inFile, std::string outFile);
+
+    /* Adds the jobs listed in a manifest: one "input output" pair per
+       line; "!" starts a comment, as in LERS files.
+       @returns True if the manifest was read; false, otherwise. */
+    bool loadManifest(std::string filename);
+
+    /* Runs all jobs on numThreads workers (zero for one per core).
+       @param stats, receives every job's statistics if non-null.
+       @returns Number of failed jobs. */
+    std::size_t run(std::size_t numThreads, Stats * stats);
+
+    /* Prints one status line per job, in submission order. */
+    void printStatus(std::ostream & stream) const;
+
+    /* Lets jobs reuse and keep rulesets in a result cache; nullptr for none. */
+    void setResultCache(ResultCache * cache);
+
+    /* Gets number of jobs. */
+    std::size_t size() const;
+
+private:
+    std::vector<Job> m_jobs;
+    Options m_options;
+    ResultCache * m_resultCache;
+
+    /* Runs one job, recording its outcome. */
+    void runJob(Job & job, Stats * stats);
+};
+#endif
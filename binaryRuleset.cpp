@@ -0,0 +1,297 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the binary ruleset format.
+    @file binaryRuleset.cpp
+
+    A ruleset laid out as flat arrays of fixed-size
+    records, so it can be memory-mapped and used in
+    place. */
+
+#include "avNumeric.hpp"
+#include "avSymbolic.hpp"
+#include "binaryRuleset.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/* Rounds a section offset up to 8 bytes. */
+static uint64_t align8(uint64_t offset){
+    return (offset + 7) & ~(uint64_t) 7;
+}
+
+BinaryRulesetWriter::BinaryRulesetWriter(Dataset * data, size_t numAttributes){
+    // FOR: Each attribute, then the decision
+    for(unsigned col = 0; col <= numAttributes; col++){
+        RulesetAttribute attribute;
+        attribute.name = addString(col < numAttributes ? data->getAttribute(col) : data->getDecision());
+        attribute.numeric = 0;
+        m_attributes.push_back(attribute);
+    }
+}
+
+void BinaryRulesetWriter::addCover(const LocalCover & lc, const vector<AV *> & avBlocks,
+                                   const vector<size_t> * weights){
+    RulesetConcept concept;
+    concept.value = addString(lc.getConcept()->getValue());
+    concept.firstRule = m_rules.size();
+    concept.numRules = lc.size();
+    concept.reserved = 0;
+    set<int> B = lc.getConcept()->getBlock();
+
+    // FOR: Each rule, record its statistics and conditions
+    for(Rule * rule : lc.getRules()){
+        set<int> block = rule->getBlock(avBlocks);
+        RulesetRule record;
+        record.concept = m_concepts.size();
+        record.firstConditionRef = m_conditionRefs.size();
+        record.specificity = rule->size();
+        record.reserved = 0;
+        record.strength = 0;
+        for(int x : block){
+            if(B.count(x)){
+                record.strength += weights ? (*weights)[x] : 1;
+            }
+        }
+        record.size = weightedSize(block, weights);
+        m_rules.push_back(record);
+
+        for(int c : rule->getConditions()){
+            // IF: Block is not in the table yet, add it
+            if(!m_conditionIndex.count(c)){
+                RulesetCondition condition;
+                condition.attribute = avBlocks[c]->getAttrCol();
+                m_attributes[condition.attribute].numeric = avBlocks[c]->isNumeric();
+                condition.value = 0;
+                condition.min = condition.max = 0;
+                if(avBlocks[c]->isNumeric()){
+                    condition.min = ((AVNumeric *) avBlocks[c])->getLowerBound();
+                    condition.max = ((AVNumeric *) avBlocks[c])->getUpperBound();
+                } else {
+                    condition.value = addString(((AVSymbolic *) avBlocks[c])->getValue());
+                }
+                m_conditionIndex[c] = m_conditions.size();
+                m_conditions.push_back(condition);
+            }
+            m_conditionRefs.push_back(m_conditionIndex[c]);
+        }
+    }
+    m_concepts.push_back(concept);
+}
+
+bool BinaryRulesetWriter::write(string filename) const {
+    RulesetHeader header;
+    memset(&header, 0, sizeof(header));
+    strncpy(header.magic, BINARY_RULESET_MAGIC, sizeof(header.magic));
+    header.version = BINARY_RULESET_VERSION;
+    header.numAttributes = m_attributes.size();
+    header.numConditions = m_conditions.size();
+    header.numConcepts = m_concepts.size();
+    header.numRules = m_rules.size();
+    header.numConditionRefs = m_conditionRefs.size();
+    header.stringsSize = m_strings.size();
+    header.attributesOffset = align8(sizeof(header));
+    header.conditionsOffset = align8(header.attributesOffset + m_attributes.size() * sizeof(RulesetAttribute));
+    header.conceptsOffset = align8(header.conditionsOffset + m_conditions.size() * sizeof(RulesetCondition));
+    header.rulesOffset = align8(header.conceptsOffset + m_concepts.size() * sizeof(RulesetConcept));
+    header.conditionRefsOffset = align8(header.rulesOffset + m_rules.size() * sizeof(RulesetRule));
+    header.stringsOffset = align8(header.conditionRefsOffset + m_conditionRefs.size() * sizeof(uint32_t));
+
+    // Write to a temporary file and rename, so readers never map a partial file
+    string tmpName = filename + ".tmp";
+    ofstream file(tmpName, ios::binary);
+    if(!file){
+        return false;
+    }
+    auto section = [&file](uint64_t offset, const void * data, size_t bytes){
+        static const char padding[8] = {0};
+        file.write(padding, offset - file.tellp());
+        file.write((const char *) data, bytes);
+    };
+    file.write((const char *) &header, sizeof(header));
+    section(header.attributesOffset, m_attributes.data(), m_attributes.size() * sizeof(RulesetAttribute));
+    section(header.conditionsOffset, m_conditions.data(), m_conditions.size() * sizeof(RulesetCondition));
+    section(header.conceptsOffset, m_concepts.data(), m_concepts.size() * sizeof(RulesetConcept));
+    section(header.rulesOffset, m_rules.data(), m_rules.size() * sizeof(RulesetRule));
+    section(header.conditionRefsOffset, m_conditionRefs.data(), m_conditionRefs.size() * sizeof(uint32_t));
+    section(header.stringsOffset, m_strings.data(), m_strings.size());
+    file.close();
+    if(!file || rename(tmpName.c_str(), filename.c_str()) != 0){
+        unlink(tmpName.c_str());
+        return false;
+    }
+    return true;
+}
+
+uint32_t BinaryRulesetWriter::addString(std::string str){
+    auto found = m_stringIndex.find(str);
+    if(found != m_stringIndex.end()){
+        return found->second;
+    }
+    uint32_t offset = m_strings.size();
+    m_strings += str;
+    m_strings += '\0';
+    m_stringIndex[str] = offset;
+    return offset;
+}
+
+BinaryRuleset::~BinaryRuleset(){
+    if(m_base){
+        munmap((void *) m_base, m_length);
+    }
+}
+
+bool BinaryRuleset::open(std::string filename){
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd < 0){
+        return false;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(RulesetHeader)){
+        close(fd);
+        return false;
+    }
+    void * base = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(base == MAP_FAILED){
+        return false;
+    }
+    m_base = (const char *) base;
+    m_length = info.st_size;
+
+    // Check the header, then that every section lies inside the file
+    const RulesetHeader & h = header();
+    bool valid = memcmp(h.magic, BINARY_RULESET_MAGIC, sizeof(BINARY_RULESET_MAGIC)) == 0
+                 && h.version == BINARY_RULESET_VERSION;
+    auto inside = [this](uint64_t offset, uint64_t count, uint64_t size){
+        return offset % 8 == 0 && offset <= m_length && count <= (m_length - offset) / size;
+    };
+    valid = valid && inside(h.attributesOffset, h.numAttributes, sizeof(RulesetAttribute))
+                  && inside(h.conditionsOffset, h.numConditions, sizeof(RulesetCondition))
+                  && inside(h.conceptsOffset, h.numConcepts, sizeof(RulesetConcept))
+                  && inside(h.rulesOffset, h.numRules, sizeof(RulesetRule))
+                  && inside(h.conditionRefsOffset, h.numConditionRefs, sizeof(uint32_t))
+                  && inside(h.stringsOffset, h.stringsSize, 1)
+                  && (h.stringsSize == 0 || m_base[h.stringsOffset + h.stringsSize - 1] == '\0');
+    valid = valid && checkReferences();
+    if(!valid){
+        munmap((void *) m_base, m_length);
+        m_base = nullptr;
+        m_length = 0;
+    }
+    return valid;
+}
+
+const RulesetHeader & BinaryRuleset::header() const {
+    return *(const RulesetHeader *) m_base;
+}
+
+bool BinaryRuleset::checkReferences() const {
+    const RulesetHeader & h = header();
+    // Decision is the last attribute, so there is at least one
+    if(h.numAttributes == 0){
+        return false;
+    }
+    for(uint32_t a = 0; a < h.numAttributes; a++){
+        if(attributes()[a].name >= h.stringsSize){
+            return false;
+        }
+    }
+    for(uint32_t c = 0; c < h.numConditions; c++){
+        const RulesetCondition & condition = conditions()[c];
+        if(condition.attribute >= h.numAttributes
+           || (!attributes()[condition.attribute].numeric && condition.value >= h.stringsSize)){
+            return false;
+        }
+    }
+    for(uint32_t c = 0; c < h.numConcepts; c++){
+        const RulesetConcept & concept = concepts()[c];
+        if(concept.value >= h.stringsSize || concept.firstRule > h.numRules
+           || concept.numRules > h.numRules - concept.firstRule){
+            return false;
+        }
+    }
+    // Rules' condition lists must follow one another, as numConditions assumes
+    uint32_t previous = 0;
+    for(uint32_t r = 0; r < h.numRules; r++){
+        const RulesetRule & rule = rules()[r];
+        if(rule.concept >= h.numConcepts || rule.firstConditionRef < previous
+           || rule.firstConditionRef > h.numConditionRefs){
+            return false;
+        }
+        previous = rule.firstConditionRef;
+    }
+    for(uint32_t i = 0; i < h.numConditionRefs; i++){
+        if(conditionRefs()[i] >= h.numConditions){
+            return false;
+        }
+    }
+    return true;
+}
+
+const RulesetAttribute * BinaryRuleset::attributes() const {
+    return (const RulesetAttribute *) (m_base + header().attributesOffset);
+}
+
+const RulesetCondition * BinaryRuleset::conditions() const {
+    return (const RulesetCondition *) (m_base + header().conditionsOffset);
+}
+
+const RulesetConcept * BinaryRuleset::concepts() const {
+    return (const RulesetConcept *) (m_base + header().conceptsOffset);
+}
+
+const RulesetRule * BinaryRuleset::rules() const {
+    return (const RulesetRule *) (m_base + header().rulesOffset);
+}
+
+const uint32_t * BinaryRuleset::conditionRefs() const {
+    return (const uint32_t *) (m_base + header().conditionRefsOffset);
+}
+
+const char * BinaryRuleset::getString(uint32_t offset) const {
+    return m_base + header().stringsOffset + offset;
+}
+
+uint32_t BinaryRuleset::numConditions(uint32_t rule) const {
+    uint32_t end = rule + 1 < header().numRules ? rules()[rule + 1].firstConditionRef
+                                                : header().numConditionRefs;
+    return end - rules()[rule].firstConditionRef;
+}
+
+void BinaryRuleset::writeText(ostream & file) const {
+    const RulesetAttribute & decision = attributes()[header().numAttributes - 1];
+
+    // FOR: Each rule, print its statistics, conditions and concept
+    for(uint32_t r = 0; r < header().numRules; r++){
+        const RulesetRule & rule = rules()[r];
+        file << rule.specificity << ", " << rule.strength << ", " << rule.size << '\n';
+        for(uint32_t i = 0; i < numConditions(r); i++){
+            file << (i ? " & " : "");
+            writeCondition(file, conditions()[conditionRefs()[rule.firstConditionRef + i]]);
+        }
+        file << " -> (" << getString(decision.name) << ", "
+             << getString(concepts()[rule.concept].value) << ")" << '\n';
+    }
+}
+
+void BinaryRuleset::writeCondition(ostream & file, const RulesetCondition & condition) const {
+    const RulesetAttribute & attribute = attributes()[condition.attribute];
+    file << "(" << getString(attribute.name) << ", ";
+    // IF: Numeric, print the interval as AVNumeric does
+    if(attribute.numeric){
+        streamsize precision = file.precision();
+        file << setprecision(8) << condition.min << ".." << condition.max << setprecision(precision);
+    } else {
+        file << getString(condition.value);
+    }
+    file << ")";
+}
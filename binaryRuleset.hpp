@@ -0,0 +1,154 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the binary ruleset format.
+    @file binaryRuleset.hpp
+
+    A ruleset laid out as flat arrays of fixed-size
+    records, so it can be memory-mapped and used in
+    place: processes mapping the same file share one
+    page-cache copy and do no parsing.
+
+    Layout (native byte order, every section 8-byte aligned):
+        header
+        attributes[numAttributes]      (decision last)
+        conditions[numConditions]      (attribute-value pairs used by rules)
+        concepts[numConcepts]
+        rules[numRules]                (grouped by concept)
+        conditionRefs[numConditionRefs] (each rule's conditions, flat)
+        strings[stringsSize]           (dictionary of NUL-terminated names and values) */
+
+#ifndef BINARY_RULESET_H
+#define BINARY_RULESET_H
+#include "av.hpp"
+#include "dataset.hpp"
+#include "localCover.hpp"
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#define BINARY_RULESET_MAGIC "MLEM2RS"
+#define BINARY_RULESET_VERSION 1
+
+struct RulesetHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t numAttributes;
+    std::uint32_t numConditions;
+    std::uint32_t numConcepts;
+    std::uint32_t numRules;
+    std::uint32_t numConditionRefs;
+    std::uint64_t stringsSize;
+    std::uint64_t attributesOffset;
+    std::uint64_t conditionsOffset;
+    std::uint64_t conceptsOffset;
+    std::uint64_t rulesOffset;
+    std::uint64_t conditionRefsOffset;
+    std::uint64_t stringsOffset;
+};
+
+struct RulesetAttribute {
+    std::uint32_t name;
+    std::uint32_t numeric;
+};
+
+struct RulesetCondition {
+    std::uint32_t attribute;
+    /* Symbolic value (string offset); unused for numeric conditions. */
+    std::uint32_t value;
+    /* Exact interval bounds of numeric conditions. */
+    float min;
+    float max;
+};
+
+struct RulesetConcept {
+    std::uint32_t value;
+    std::uint32_t firstRule;
+    std::uint32_t numRules;
+    std::uint32_t reserved;
+};
+
+struct RulesetRule {
+    std::uint32_t concept;
+    std::uint32_t firstConditionRef;
+    std::uint32_t specificity;
+    std::uint32_t reserved;
+    std::uint64_t strength;
+    std::uint64_t size;
+};
+
+/* Collects coverings as they are induced and writes them in binary. */
+class BinaryRulesetWriter {
+public:
+    /* Only the attribute and decision names of the dataset are used. */
+    BinaryRulesetWriter(Dataset * data, std::size_t numAttributes);
+
+    /* Adds the rules of a covering, with their statistics. */
+    void addCover(const LocalCover & lc, const std::vector<AV *> & avBlocks,
+                  const std::vector<std::size_t> * weights = nullptr);
+
+    /* Writes all added coverings.
+       @returns True if file write is successful; false, otherwise. */
+    bool write(std::string filename) const;
+
+private:
+    std::vector<RulesetAttribute> m_attributes;
+    std::vector<RulesetCondition> m_conditions;
+    std::vector<RulesetConcept> m_concepts;
+    std::vector<RulesetRule> m_rules;
+    std::vector<std::uint32_t> m_conditionRefs;
+    std::string m_strings;
+
+    /* Block index -> condition index. */
+    std::map<int, std::uint32_t> m_conditionIndex;
+    std::map<std::string, std::uint32_t> m_stringIndex;
+
+    /* Adds a string to the dictionary once.
+       @returns Offset of the string. */
+    std::uint32_t addString(std::string str);
+};
+
+/* A read-only, memory-mapped binary ruleset. */
+class BinaryRuleset {
+public:
+    BinaryRuleset() : m_base(nullptr), m_length(0) { }
+    ~BinaryRuleset();
+    BinaryRuleset(const BinaryRuleset &) = delete;
+    BinaryRuleset & operator=(const BinaryRuleset &) = delete;
+
+    /* Maps a file and checks its header, section bounds and the
+       indices and string offsets inside the sections.
+       @returns True if the file is a valid ruleset; false, otherwise. */
+    bool open(std::string filename);
+
+    const RulesetHeader & header() const;
+    const RulesetAttribute * attributes() const;
+    const RulesetCondition * conditions() const;
+    const RulesetConcept * concepts() const;
+    const RulesetRule * rules() const;
+    const std::uint32_t * conditionRefs() const;
+
+    /* Gets a string from the dictionary. */
+    const char * getString(std::uint32_t offset) const;
+
+    /* Gets the number of conditions of a rule. */
+    std::uint32_t numConditions(std::uint32_t rule) const;
+
+    /* Prints the ruleset in the text format. */
+    void writeText(std::ostream & file) const;
+
+private:
+    const char * m_base;
+    std::size_t m_length;
+
+    /* Prints a condition as (attribute, value). */
+    void writeCondition(std::ostream & file, const RulesetCondition & condition) const;
+
+    /* open HELPER: Checks that every index points into its section and every
+       string offset into the dictionary, so reading the ruleset stays in the file. */
+    bool checkReferences() const;
+};
+#endif
@@ -0,0 +1,248 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the block store class.
+    @file blockStore.cpp
+
+    This class keeps attribute-value blocks out of
+    core, as rows of a memory-mapped bit matrix. */
+
+#include "blockStore.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+using namespace std;
+
+/* Gets the major page faults of the process so far. */
+static long majorFaults(){
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_majflt;
+}
+
+BlockStore::BlockStore(size_t numCases, size_t residentBytes)
+    : m_numCases(numCases), m_residentBytes(residentBytes), m_fd(-1),
+      m_base(nullptr), m_length(0), m_numRows(0), m_bytesWritten(0),
+      m_pagesRead(0), m_residentPages(0), m_drops(0), m_faultsAtSeal(0) {
+    // Bit x is case x, so bit 0 is unused
+    m_rowWords = numCases / 64 + 1;
+    m_summaryWords = (numCases / STORE_CHUNK_CASES) / 64 + 1;
+    m_pageSize = sysconf(_SC_PAGESIZE);
+}
+
+BlockStore::~BlockStore(){
+    if(m_base){
+        munmap((void *) m_base, m_length);
+    }
+    if(m_fd >= 0){
+        close(m_fd);
+    }
+}
+
+bool BlockStore::create(string directory){
+    string path = directory + "/mlem2-blocks-XXXXXX";
+    vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    m_fd = mkstemp(name.data());
+    if(m_fd < 0){
+        return false;
+    }
+    // The file lives only as long as the descriptor
+    unlink(name.data());
+    return true;
+}
+
+size_t BlockStore::getRowWords() const {
+    return m_rowWords;
+}
+
+bool BlockStore::addRow(const vector<uint64_t> & bits, size_t & row){
+    const char * data = (const char *) bits.data();
+    size_t left = m_rowWords * sizeof(uint64_t);
+    // WHILE: Part of the row is unwritten
+    while(left > 0){
+        ssize_t written = write(m_fd, data, left);
+        if(written <= 0){
+            return false;
+        }
+        data += written;
+        left -= written;
+    }
+    m_bytesWritten += m_rowWords * sizeof(uint64_t);
+
+    // Keep the count, hash and chunk summary in memory
+    size_t count = 0;
+    uint64_t hash = 14695981039346656037ULL;
+    m_summary.resize(m_summary.size() + m_summaryWords, 0);
+    uint64_t * summary = &m_summary[m_numRows * m_summaryWords];
+    for(size_t w = 0; w < m_rowWords; w++){
+        uint64_t word = bits[w];
+        if(word){
+            size_t chunk = w * 64 / STORE_CHUNK_CASES;
+            summary[chunk / 64] |= 1ULL << (chunk % 64);
+        }
+        // WHILE: Word has cases left, fold the lowest into the hash
+        while(word){
+            int x = w * 64 + __builtin_ctzll(word);
+            hash = (hash ^ (uint64_t) x) * 1099511628211ULL;
+            count++;
+            word &= word - 1;
+        }
+    }
+    m_counts.push_back(count);
+    m_hashes.push_back(hash);
+    row = m_numRows++;
+    return true;
+}
+
+bool BlockStore::seal(){
+    m_length = m_numRows * m_rowWords * sizeof(uint64_t);
+    if(m_length == 0){
+        return true;
+    }
+    void * base = mmap(nullptr, m_length, PROT_READ, MAP_SHARED, m_fd, 0);
+    if(base == MAP_FAILED){
+        m_length = 0;
+        return false;
+    }
+    m_base = (const uint64_t *) base;
+    m_resident.assign((m_length + m_pageSize - 1) / m_pageSize / 64 + 1, 0);
+    m_faultsAtSeal = majorFaults();
+    return true;
+}
+
+size_t BlockStore::count(size_t row) const {
+    return m_counts[row];
+}
+
+uint64_t BlockStore::hash(size_t row) const {
+    return m_hashes[row];
+}
+
+set<int> BlockStore::cases(size_t row){
+    set<int> result;
+    const uint64_t * bits = m_base + row * m_rowWords;
+    size_t lastPage = SIZE_MAX;
+
+    // FOR: Each word in a non-empty chunk, add its cases
+    for(size_t w = 0; w < m_rowWords; w++){
+        if(!hasChunk(row, w * 64 / STORE_CHUNK_CASES)){
+            w = (w * 64 / STORE_CHUNK_CASES + 1) * (STORE_CHUNK_CASES / 64) - 1;
+            continue;
+        }
+        size_t page = (row * m_rowWords + w) * sizeof(uint64_t) / m_pageSize;
+        if(page != lastPage){
+            touch(page);
+            lastPage = page;
+        }
+        uint64_t word = bits[w];
+        while(word){
+            result.insert(result.end(), w * 64 + __builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+    return result;
+}
+
+set<int> BlockStore::intersect(size_t row, const set<int> & other){
+    set<int> result;
+    const uint64_t * bits = m_base + row * m_rowWords;
+    size_t lastPage = SIZE_MAX;
+
+    // FOR: Each case of the other set, test its bit unless its chunk is empty
+    for(auto it = other.begin(); it != other.end(); ){
+        size_t x = *it;
+        if(x > m_numCases){
+            break;
+        }
+        size_t chunk = x / STORE_CHUNK_CASES;
+        if(!hasChunk(row, chunk)){
+            it = other.lower_bound((chunk + 1) * STORE_CHUNK_CASES);
+            continue;
+        }
+        size_t page = (row * m_rowWords + x / 64) * sizeof(uint64_t) / m_pageSize;
+        if(page != lastPage){
+            touch(page);
+            lastPage = page;
+        }
+        if(bits[x / 64] & (1ULL << (x % 64))){
+            result.insert(result.end(), x);
+        }
+        ++it;
+    }
+    return result;
+}
+
+size_t BlockStore::intersectCount(size_t row, const set<int> & other, const vector<size_t> * weights){
+    const uint64_t * bits = m_base + row * m_rowWords;
+    size_t count = 0;
+    size_t lastPage = SIZE_MAX;
+
+    // FOR: Each case of the other set, test its bit unless its chunk is empty
+    for(auto it = other.begin(); it != other.end(); ){
+        size_t x = *it;
+        if(x > m_numCases){
+            break;
+        }
+        size_t chunk = x / STORE_CHUNK_CASES;
+        if(!hasChunk(row, chunk)){
+            it = other.lower_bound((chunk + 1) * STORE_CHUNK_CASES);
+            continue;
+        }
+        size_t page = (row * m_rowWords + x / 64) * sizeof(uint64_t) / m_pageSize;
+        if(page != lastPage){
+            touch(page);
+            lastPage = page;
+        }
+        if(bits[x / 64] & (1ULL << (x % 64))){
+            count += weights ? (*weights)[x] : 1;
+        }
+        ++it;
+    }
+    return count;
+}
+
+uint64_t BlockStore::getBytesWritten() const {
+    return m_bytesWritten;
+}
+
+uint64_t BlockStore::getBytesRead() const {
+    return m_pagesRead * m_pageSize;
+}
+
+uint64_t BlockStore::getMajorFaults() const {
+    return m_base ? majorFaults() - m_faultsAtSeal : 0;
+}
+
+void BlockStore::report(ostream & out) const {
+    out << "Block store: " << m_numRows << " blocks, "
+        << m_bytesWritten / (1024.0 * 1024.0) << " MiB written, "
+        << getBytesRead() / (1024.0 * 1024.0) << " MiB paged in ("
+        << getMajorFaults() << " major page faults), "
+        << m_drops << " resident page drops" << endl;
+}
+
+bool BlockStore::hasChunk(size_t row, size_t chunk) const {
+    return m_summary[row * m_summaryWords + chunk / 64] & (1ULL << (chunk % 64));
+}
+
+void BlockStore::touch(size_t page){
+    uint64_t & word = m_resident[page / 64];
+    if(word & (1ULL << (page % 64))){
+        return;
+    }
+    // IF: Paging in would exceed the resident budget, drop the mapped pages first
+    if((m_residentPages + 1) * m_pageSize > m_residentBytes && m_residentPages > 0){
+        madvise((void *) m_base, m_length, MADV_DONTNEED);
+        fill(m_resident.begin(), m_resident.end(), 0);
+        m_residentPages = 0;
+        m_drops++;
+    }
+    word |= 1ULL << (page % 64);
+    m_residentPages++;
+    m_pagesRead++;
+}
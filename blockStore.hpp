@@ -0,0 +1,115 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the block store class.
+    @file blockStore.hpp
+
+    This class keeps attribute-value blocks out of
+    core: each block is one row of a bit matrix (bit x
+    set if case x is in the block) in a memory-mapped
+    scratch file. Only the row counts, hashes and a
+    summary of which page-sized chunks of each row
+    have cases stay in memory, so a lookup only pages
+    in the parts of a row the other set falls in. */
+
+#ifndef BLOCK_STORE_H
+#define BLOCK_STORE_H
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+/* Cases per chunk of a row: the bits of one 4 KiB page. */
+#define STORE_CHUNK_CASES 32768
+
+class BlockStore {
+public:
+    /* @param residentBytes, the mapped pages are all dropped before
+              more than this many bytes of them would be resident. */
+    BlockStore(std::size_t numCases, std::size_t residentBytes);
+    ~BlockStore();
+    BlockStore(const BlockStore &) = delete;
+    BlockStore & operator=(const BlockStore &) = delete;
+
+    /* Creates the (already unlinked) scratch file in a directory.
+       @returns True if successful; false, otherwise. */
+    bool create(std::string directory);
+
+    /* Gets the number of 64-bit words in a row. */
+    std::size_t getRowWords() const;
+
+    /* Appends a row; rows can only be read once the store is sealed.
+       @returns True if the row was written; false, otherwise. */
+    bool addRow(const std::vector<std::uint64_t> & bits, std::size_t & row);
+
+    /* Maps the rows written so far for reading.
+       @returns True if successful; false, otherwise. */
+    bool seal();
+
+    /* Gets the number of cases of a row (kept in memory). */
+    std::size_t count(std::size_t row) const;
+
+    /* Gets the FNV-1a hash of a row's cases, in increasing order, as
+       AV::contentHash computes it (kept in memory). */
+    std::uint64_t hash(std::size_t row) const;
+
+    /* Gets all cases of a row. */
+    std::set<int> cases(std::size_t row);
+
+    /* Gets the cases of a set that are in a row. */
+    std::set<int> intersect(std::size_t row, const std::set<int> & other);
+
+    /* Counts the cases of a set that are in a row, weighted by
+       multiplicity if weights are given. */
+    std::size_t intersectCount(std::size_t row, const std::set<int> & other,
+                               const std::vector<std::size_t> * weights);
+
+    std::uint64_t getBytesWritten() const;
+
+    /* Gets the bytes of pages lookups made resident, counting a page again
+       after it was dropped; pages may come from the page cache, so this
+       bounds the bytes actually read from disk. */
+    std::uint64_t getBytesRead() const;
+
+    /* Gets the major page faults (pages read from disk) since sealing. */
+    std::uint64_t getMajorFaults() const;
+
+    /* Prints a one-line summary of the store's size and I/O. */
+    void report(std::ostream & out) const;
+
+private:
+    std::size_t m_numCases;
+    std::size_t m_rowWords;
+    std::size_t m_summaryWords;
+    std::size_t m_residentBytes;
+    std::size_t m_pageSize;
+    int m_fd;
+    const std::uint64_t * m_base;
+    std::size_t m_length;
+    std::size_t m_numRows;
+
+    /* Per row: case count, hash and one bit per non-empty chunk. */
+    std::vector<std::size_t> m_counts;
+    std::vector<std::uint64_t> m_hashes;
+    std::vector<std::uint64_t> m_summary;
+
+    std::uint64_t m_bytesWritten;
+    std::uint64_t m_pagesRead;
+    std::uint64_t m_residentPages;
+    std::uint64_t m_drops;
+    long m_faultsAtSeal;
+
+    /* One bit per page of the mapping touched since the last drop. */
+    std::vector<std::uint64_t> m_resident;
+
+    /* Checks if a chunk of a row has any cases. */
+    bool hasChunk(std::size_t row, std::size_t chunk) const;
+
+    /* Records that a lookup reads a page, dropping the resident
+       pages first if it would exceed the budget. */
+    void touch(std::size_t page);
+};
+#endif
@@ -0,0 +1,283 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the checkpoint class.
+    @file checkpoint.cpp
+
+    This class saves the progress of an induction
+    run, so a preempted run can resume where it
+    stopped. */
+
+#include "checkpoint.hpp"
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+using namespace std;
+
+/* First word of a checkpoint file. */
+static const string CHECKPOINT_MAGIC = "MLEM2CKPT";
+
+/* Reads "<count> <rules>" then one "<n> <block> ..." line per rule.
+   @returns False if the rules are damaged or name unknown blocks. */
+static bool readRules(istream & file, size_t numBlocks, vector<set<int>> & rules){
+    size_t numRules = 0;
+    if(!(file >> numRules)){
+        return false;
+    }
+    rules.assign(numRules, set<int>());
+    // FOR: Each rule, read its condition blocks
+    for(set<int> & conditions : rules){
+        size_t numConditions = 0;
+        if(!(file >> numConditions) || numConditions == 0){
+            return false;
+        }
+        for(size_t i = 0; i < numConditions; i++){
+            size_t block = 0;
+            if(!(file >> block) || block >= numBlocks){
+                return false;
+            }
+            conditions.insert(block);
+        }
+    }
+    return true;
+}
+
+/* Writes the rules in the format readRules reads. */
+static void writeRules(ostream & file, const vector<set<int>> & rules){
+    file << rules.size() << '\n';
+    for(const set<int> & conditions : rules){
+        file << conditions.size();
+        for(int block : conditions){
+            file << ' ' << block;
+        }
+        file << '\n';
+    }
+}
+
+Checkpoint::Checkpoint(string filename, uint64_t key, double intervalSeconds)
+    : m_filename(filename), m_key(key), m_interval(intervalSeconds),
+      m_lastSave(chrono::steady_clock::now()), m_numSaves(0), m_partial(false), m_inProgress(false) { }
+
+bool Checkpoint::load(size_t numBlocks){
+    ifstream file(m_filename);
+    // IF: No checkpoint, start from the beginning
+    if(!file){
+        return true;
+    }
+
+    string magic, word;
+    uint64_t key = 0;
+    if(!(file >> magic >> hex >> key >> dec) || magic != CHECKPOINT_MAGIC){
+        m_error = "damaged checkpoint " + m_filename;
+        return false;
+    }
+    if(key != m_key){
+        m_error = "checkpoint " + m_filename + " is of another dataset or other options";
+        return false;
+    }
+
+    // WHILE: Another section follows, read it; only a progress section may end the file
+    while(file >> word){
+        // IF: Deadline was reached before the save, the rules are partial quality
+        if(word == "partial" && m_finished.empty() && !m_inProgress){
+            m_partial = true;
+            continue;
+        }
+        size_t concept = 0;
+        vector<set<int>> rules;
+        bool valid = (word == "finished" || word == "progress") && !m_inProgress
+                     && file >> concept && concept == m_finished.size()
+                     && readRules(file, numBlocks, rules);
+        if(valid && word == "progress"){
+            string label;
+            size_t numCases = 0;
+            valid = file >> label >> numCases && label == "G";
+            for(size_t i = 0; valid && i < numCases; i++){
+                int x = 0;
+                valid = (bool) (file >> x);
+                m_progressG.insert(x);
+            }
+            m_progressRules = rules;
+            m_inProgress = valid;
+        } else if(valid){
+            m_finished.push_back(rules);
+        }
+        if(!valid){
+            m_finished.clear();
+            m_progressRules.clear();
+            m_progressG.clear();
+            m_inProgress = false;
+            m_error = "damaged checkpoint " + m_filename;
+            return false;
+        }
+    }
+    return true;
+}
+
+string Checkpoint::getError() const {
+    return m_error;
+}
+
+void Checkpoint::setInputCases(const vector<size_t> * inputCases){
+    m_inputCases.clear();
+    m_renumbered.clear();
+    if(!inputCases){
+        return;
+    }
+    m_inputCases = *inputCases;
+    m_renumbered.assign(m_inputCases.size(), 0);
+    for(size_t x = 1; x < m_inputCases.size(); x++){
+        m_renumbered[m_inputCases[x]] = x;
+    }
+}
+
+void Checkpoint::setPartial(){
+    m_partial = true;
+}
+
+bool Checkpoint::isPartial() const {
+    return m_partial;
+}
+
+size_t Checkpoint::getNumFinished() const {
+    return m_finished.size();
+}
+
+size_t Checkpoint::getNumProgressRules() const {
+    return m_inProgress ? m_progressRules.size() : 0;
+}
+
+bool Checkpoint::resumeFinished(size_t concept, LocalCover & lc) const {
+    if(concept >= m_finished.size()){
+        return false;
+    }
+    for(const set<int> & conditions : m_finished[concept]){
+        Rule * rule = new Rule();
+        rule->setConditions(conditions);
+        lc.addRule(rule);
+    }
+    return true;
+}
+
+bool Checkpoint::resumeProgress(size_t concept, LocalCover & lc, set<int> & G) const {
+    if(!m_inProgress || concept != m_finished.size()){
+        return false;
+    }
+    for(const set<int> & conditions : m_progressRules){
+        Rule * rule = new Rule();
+        rule->setConditions(conditions);
+        lc.addRule(rule);
+    }
+    G = m_progressG;
+    // IF: Cases were renumbered, translate them back
+    if(!m_renumbered.empty()){
+        G.clear();
+        for(int x : m_progressG){
+            if(x > 0 && (size_t) x < m_renumbered.size()){
+                G.insert(m_renumbered[x]);
+            }
+        }
+    }
+    return true;
+}
+
+void Checkpoint::finish(size_t concept, const LocalCover & lc){
+    // IF: Concept was resumed as finished, it is recorded already
+    if(concept < m_finished.size()){
+        return;
+    }
+    m_finished.push_back(ruleConditions(lc));
+    m_inProgress = false;
+    m_progressRules.clear();
+    m_progressG.clear();
+    saveIfDue();
+}
+
+void Checkpoint::progress(size_t concept, const LocalCover & lc, const set<int> & G){
+    if(concept != m_finished.size()){
+        return;
+    }
+    m_inProgress = true;
+    m_progressRules = ruleConditions(lc);
+    m_progressG = G;
+    // IF: Cases were renumbered, keep them by their numbers before
+    if(!m_inputCases.empty()){
+        m_progressG.clear();
+        for(int x : G){
+            m_progressG.insert(m_inputCases[x]);
+        }
+    }
+    saveIfDue();
+}
+
+void Checkpoint::complete(){
+    unlink(m_filename.c_str());
+}
+
+size_t Checkpoint::getNumSaves() const {
+    return m_numSaves;
+}
+
+vector<set<int>> Checkpoint::ruleConditions(const LocalCover & lc){
+    vector<set<int>> rules;
+    for(Rule * rule : lc.getRules()){
+        rules.push_back(rule->getConditions());
+    }
+    return rules;
+}
+
+void Checkpoint::saveIfDue(){
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - m_lastSave;
+    if(elapsed.count() < m_interval){
+        return;
+    }
+    if(!save()){
+        cerr << "Unable to write checkpoint: " << m_filename << endl;
+    }
+    m_lastSave = chrono::steady_clock::now();
+}
+
+bool Checkpoint::save(){
+    string tmpName = m_filename + ".tmp";
+    ofstream file(tmpName);
+    file << CHECKPOINT_MAGIC << ' ' << hex << m_key << dec << '\n';
+    if(m_partial){
+        file << "partial\n";
+    }
+    for(unsigned c = 0; c < m_finished.size(); c++){
+        file << "finished " << c << ' ';
+        writeRules(file, m_finished[c]);
+    }
+    if(m_inProgress){
+        file << "progress " << m_finished.size() << ' ';
+        writeRules(file, m_progressRules);
+        file << "G " << m_progressG.size();
+        for(int x : m_progressG){
+            file << ' ' << x;
+        }
+        file << '\n';
+    }
+    file.close();
+    if(!file){
+        unlink(tmpName.c_str());
+        return false;
+    }
+
+    // Make the contents durable before the rename makes them the checkpoint
+    int fd = open(tmpName.c_str(), O_RDONLY);
+    if(fd >= 0){
+        fsync(fd);
+        close(fd);
+    }
+    if(rename(tmpName.c_str(), m_filename.c_str()) != 0){
+        unlink(tmpName.c_str());
+        return false;
+    }
+    m_numSaves++;
+    return true;
+}
@@ -0,0 +1,117 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the checkpoint class.
+    @file checkpoint.hpp
+
+    This class saves the progress of an induction
+    run, so a preempted run can resume where it
+    stopped. A checkpoint is a text file, replaced
+    atomically (written to a temporary file, then
+    renamed), holding:
+        MLEM2CKPT <key>                 dataset and options it is of
+        partial                         if a deadline cut induction short
+        finished <concept> <rules>      per finished concept, in order,
+        <n> <block> ... <block>         then one line per rule
+        progress <concept> <rules>      concept being covered, if any,
+        <n> <block> ... <block>         its rules so far,
+        G <n> <case> ... <case>         and the cases still to cover
+    Rules are stored by the indices of their condition
+    blocks, so they only mean something with the same
+    dataset and options, which the key identifies.
+    Cases are stored by the number they had before any
+    renumbering, so resuming does not depend on it. */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+#include "localCover.hpp"
+#include <chrono>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+class Checkpoint {
+public:
+    /* @param intervalSeconds, least time between two saves. */
+    Checkpoint(std::string filename, std::uint64_t key, double intervalSeconds);
+
+    /* Reads the saved progress, if there is any.
+       @param numBlocks, number of attribute-value blocks of this run.
+       @returns False if a checkpoint exists but is of another dataset or
+                options, or is damaged; it is then not resumed or replaced. */
+    bool load(std::size_t numBlocks);
+
+    /* Gets why load failed. */
+    std::string getError() const;
+
+    /* Translates case numbers through a map from case number to the
+       number before renumbering (see Dataset::renumberCases); null (the
+       default) when cases were not renumbered. */
+    void setInputCases(const std::vector<std::size_t> * inputCases);
+
+    /* Gets the number of finished concepts loaded. */
+    std::size_t getNumFinished() const;
+
+    /* Marks the saved rules as partial quality: a deadline was reached. */
+    void setPartial();
+
+    /* Checks if a deadline was reached before or since the checkpoint was loaded. */
+    bool isPartial() const;
+
+    /* Gets the number of rules of the concept in progress; 0 if none. */
+    std::size_t getNumProgressRules() const;
+
+    /* Checks if a concept was finished; if so, adds its rules to the covering. */
+    bool resumeFinished(std::size_t concept, LocalCover & lc) const;
+
+    /* Checks if a concept was in progress; if so, adds its rules so far
+       to the covering and gets the cases that were still to be covered. */
+    bool resumeProgress(std::size_t concept, LocalCover & lc, std::set<int> & G) const;
+
+    /* Records a finished concept and saves if the interval has passed. */
+    void finish(std::size_t concept, const LocalCover & lc);
+
+    /* Records the concept being covered and saves if the interval has passed. */
+    void progress(std::size_t concept, const LocalCover & lc, const std::set<int> & G);
+
+    /* Removes the checkpoint once the output is complete. */
+    void complete();
+
+    /* Gets the number of times the checkpoint was saved. */
+    std::size_t getNumSaves() const;
+
+private:
+    std::string m_filename;
+    std::uint64_t m_key;
+    double m_interval;
+    std::chrono::steady_clock::time_point m_lastSave;
+    std::size_t m_numSaves;
+    std::string m_error;
+    bool m_partial;
+
+    /* Conditions of each rule of each finished concept, in concept order. */
+    std::vector<std::vector<std::set<int>>> m_finished;
+
+    /* Concept being covered (m_finished.size() when valid), its rules and G
+       (by number before renumbering). */
+    bool m_inProgress;
+    std::vector<std::set<int>> m_progressRules;
+    std::set<int> m_progressG;
+
+    /* Case number to number before renumbering, and back; empty if none. */
+    std::vector<std::size_t> m_inputCases;
+    std::vector<int> m_renumbered;
+
+    /* Gets the conditions of every rule of a covering, in rule order. */
+    static std::vector<std::set<int>> ruleConditions(const LocalCover & lc);
+
+    /* Saves now if the interval has passed since the last save. */
+    void saveIfDue();
+
+    /* Writes the state to a temporary file and renames it over the checkpoint.
+       @returns True if successful; false, otherwise. */
+    bool save();
+};
+#endif
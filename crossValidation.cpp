@@ -0,0 +1,204 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the cross-validation class.
+    @file crossValidation.cpp
+
+    This class estimates the error rate of MLEM2
+    rulesets with stratified k-fold cross-validation.
+    The dataset is parsed once; each fold masks its
+    held-out cases out of the blocks and concepts. */
+
+#include "algorithm.hpp"
+#include "crossValidation.hpp"
+#include "threadPool.hpp"
+#include <chrono>
+#include <iomanip>
+
+using namespace std;
+
+CrossValidation::CrossValidation(Dataset * data, size_t numAttributes, size_t numFolds,
+                                 CutpointMode cutpointMode, size_t maxCutpoints)
+    : m_data(data), m_numAttributes(numAttributes), m_numFolds(numFolds),
+      m_mode(CV_RECOMPUTE_CUTPOINTS), m_cutpointMode(cutpointMode),
+      m_maxCutpoints(maxCutpoints) {
+    assignFolds();
+}
+
+void CrossValidation::run(CutpointSharing mode, size_t numThreads){
+    m_mode = mode;
+    m_results.assign(m_numFolds, FoldResult());
+
+    // IF: Cutpoints are shared, build the full blocks once for all folds
+    Algorithm builder(m_numAttributes);
+    builder.setCutpointMode(m_cutpointMode, m_maxCutpoints);
+    if(mode == CV_SHARED_CUTPOINTS){
+        builder.generateAVBlocks(m_data);
+    }
+    vector<AV *> fullBlocks = builder.getAVBlocks();
+
+    {
+        ThreadPool pool(numThreads);
+        for(unsigned f = 0; f < m_numFolds; f++){
+            pool.submit([this, f, &fullBlocks]{ m_results[f] = runFold(f, fullBlocks); });
+        }
+        pool.wait();
+    }
+
+    for(AV * av : fullBlocks){
+        delete av;
+    }
+}
+
+void CrossValidation::report(ostream & stream) const {
+    FoldResult total;
+    stream << (m_mode == CV_SHARED_CUTPOINTS ? "shared" : "recomputed") << " cutpoints, "
+           << m_numFolds << " folds" << endl;
+    stream << "fold\ttrain\ttest\tblocks\trules\terrors\tunclassified\terror_rate\tseconds" << endl;
+    for(unsigned f = 0; f < m_results.size(); f++){
+        const FoldResult & r = m_results[f];
+        stream << f + 1 << "\t" << r.trainSize << "\t" << r.testSize << "\t" << r.numBlocks
+               << "\t" << r.numRules << "\t" << r.errors << "\t" << r.unclassified << "\t"
+               << fixed << setprecision(4) << (r.testSize ? (double) r.errors / r.testSize : 0)
+               << "\t" << r.seconds << defaultfloat << endl;
+        total.testSize += r.testSize;
+        total.errors += r.errors;
+        total.unclassified += r.unclassified;
+        total.seconds += r.seconds;
+    }
+    stream << "total\t\t" << total.testSize << "\t\t\t" << total.errors << "\t" << total.unclassified
+           << "\t" << fixed << setprecision(4)
+           << (total.testSize ? (double) total.errors / total.testSize : 0)
+           << "\t" << total.seconds << defaultfloat << endl;
+}
+
+void CrossValidation::assignFolds(){
+    m_folds.assign(m_numFolds, set<int>());
+    Algorithm mlem2(m_numAttributes);
+    vector<Concept *> concepts = mlem2.generateConcepts(m_data);
+
+    size_t next = 0;
+    // FOR: Each concept, deal its cases into folds so every fold is stratified
+    for(Concept * concept : concepts){
+        for(int x : concept->getBlock()){
+            m_folds[next % m_numFolds].insert(x);
+            next++;
+        }
+        delete concept;
+    }
+}
+
+FoldResult CrossValidation::runFold(size_t fold, const vector<AV *> & fullBlocks){
+    TraceSpan span("crossValidationFold", to_string(fold + 1));
+    auto start = chrono::steady_clock::now();
+    FoldResult result;
+    const set<int> & heldOut = m_folds[fold];
+
+    set<int> training;
+    for(unsigned r = 1; r <= m_data->getNumCases(); r++){
+        if(!heldOut.count(r)){
+            training.insert(r);
+        }
+    }
+    result.trainSize = training.size();
+    result.testSize = heldOut.size();
+
+    // Mask held-out cases out of the blocks, or rebuild blocks from training cases
+    Algorithm mlem2(m_numAttributes);
+    mlem2.setCutpointMode(m_cutpointMode, m_maxCutpoints);
+    vector<AV *> blocks;
+    if(m_mode == CV_SHARED_CUTPOINTS){
+        for(AV * av : fullBlocks){
+            AV * masked = av->clone();
+            masked->setBlock(setIntersection(av->getBlock(), training));
+            blocks.push_back(masked);
+        }
+        mlem2.setAVBlocks(blocks);
+    } else {
+        mlem2.generateAVBlocks(m_data, &training);
+        blocks = mlem2.getAVBlocks();
+    }
+    result.numBlocks = blocks.size();
+
+    // Mask held-out cases out of the concepts and induce each one
+    vector<Concept *> concepts = mlem2.generateConcepts(m_data);
+    vector<Concept *> masked;
+    vector<vector<ScoredRule>> rules;
+    for(Concept * concept : concepts){
+        Concept * trainConcept = new Concept(concept->getDecision(), concept->getValue());
+        for(int x : setIntersection(concept->getBlock(), training)){
+            trainConcept->addCase(x);
+        }
+        masked.push_back(trainConcept);
+        rules.push_back(vector<ScoredRule>());
+        delete concept;
+
+        // IF: Concept has no training cases, it gets no rules
+        if(trainConcept->getBlockSize() == 0){
+            continue;
+        }
+        LocalCover lc = mlem2.induceRules(trainConcept);
+        for(Rule * rule : lc.getRules()){
+            rules.back().push_back({rule->getConditions(), rule->getBlock(blocks).size()});
+            delete rule;
+        }
+        result.numRules += lc.size();
+    }
+
+    // FOR: Each held-out case, classify and compare with its decision
+    for(int x : heldOut){
+        int predicted = classify(x, blocks, rules);
+        if(predicted < 0){
+            result.unclassified++;
+            result.errors++;
+        } else if(masked[predicted]->getValue() != m_data->getValue(x, m_numAttributes)->getStrValue()){
+            result.errors++;
+        }
+    }
+
+    for(Concept * concept : masked){
+        delete concept;
+    }
+    for(AV * av : blocks){
+        delete av;
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    result.seconds = elapsed.count();
+    return result;
+}
+
+int CrossValidation::classify(int x, const vector<AV *> & blocks,
+                              const vector<vector<ScoredRule>> & rules) const {
+    vector<double> complete(rules.size(), 0), partial(rules.size(), 0);
+    bool anyComplete = false;
+
+    // FOR: Each concept's rules, add support from matching rules
+    for(unsigned c = 0; c < rules.size(); c++){
+        for(const ScoredRule & rule : rules[c]){
+            size_t matched = 0;
+            for(int i : rule.conditions){
+                if(blocks[i]->matches(m_data->getValue(x, blocks[i]->getAttrCol()))){
+                    matched++;
+                }
+            }
+            double support = (double) rule.strength * rule.conditions.size();
+            if(matched == rule.conditions.size()){
+                complete[c] += support;
+                anyComplete = true;
+            } else if(matched > 0){
+                partial[c] += support * matched / rule.conditions.size();
+            }
+        }
+    }
+
+    // Largest support wins; ties go to the first concept
+    const vector<double> & scores = anyComplete ? complete : partial;
+    int best = -1;
+    for(unsigned c = 0; c < scores.size(); c++){
+        if(scores[c] > 0 && (best < 0 || scores[c] > scores[best])){
+            best = c;
+        }
+    }
+    return best;
+}
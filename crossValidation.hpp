@@ -0,0 +1,77 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the cross-validation class.
+    @file crossValidation.hpp
+
+    This class estimates the error rate of MLEM2
+    rulesets with stratified k-fold cross-validation.
+    The dataset is parsed once; each fold masks its
+    held-out cases out of the blocks and concepts. */
+
+#ifndef CROSS_VALIDATION_H
+#define CROSS_VALIDATION_H
+#include "av.hpp"
+#include "dataset.hpp"
+#include "localCover.hpp"
+#include "options.hpp"
+#include <ostream>
+#include <set>
+#include <vector>
+
+struct FoldResult {
+    std::size_t trainSize = 0;
+    std::size_t testSize = 0;
+    std::size_t numBlocks = 0;
+    std::size_t numRules = 0;
+    std::size_t errors = 0;
+    std::size_t unclassified = 0;
+    double seconds = 0;
+};
+
+class CrossValidation {
+public:
+    CrossValidation(Dataset * data, std::size_t numAttributes, std::size_t numFolds,
+                    CutpointMode cutpointMode = CUT_ALL, std::size_t maxCutpoints = 256);
+
+    /* Induces and scores every fold, numThreads folds at a time.
+       @param mode, CV_SHARED_CUTPOINTS builds blocks once on the full data
+              and masks them per fold; CV_RECOMPUTE_CUTPOINTS rebuilds blocks
+              from each fold's training cases (no re-parse). */
+    void run(CutpointSharing mode, std::size_t numThreads);
+
+    /* Prints a table of per-fold and total results. */
+    void report(std::ostream & stream) const;
+
+private:
+    /* A rule with the statistics used for classification. */
+    struct ScoredRule {
+        std::set<int> conditions;
+        std::size_t strength;
+    };
+
+    Dataset * m_data;
+    std::size_t m_numAttributes;
+    std::size_t m_numFolds;
+    CutpointSharing m_mode;
+    CutpointMode m_cutpointMode;
+    std::size_t m_maxCutpoints;
+
+    /* Held-out cases of each fold. */
+    std::vector<std::set<int>> m_folds;
+    std::vector<FoldResult> m_results;
+
+    /* Deals the cases of every concept round-robin into folds. */
+    void assignFolds();
+
+    /* Induces rules without the fold's cases and classifies them. */
+    FoldResult runFold(std::size_t fold, const std::vector<AV *> & fullBlocks);
+
+    /* Classifies a case by LERS support (strength x specificity), falling
+       back to partial matching when no rule matches completely.
+       @returns Index of the winning concept, or -1 if no rule matches at all. */
+    int classify(int x, const std::vector<AV *> & blocks,
+                 const std::vector<std::vector<ScoredRule>> & rules) const;
+};
+#endif
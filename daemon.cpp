@@ -0,0 +1,207 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the daemon class.
+    @file daemon.cpp
+
+    This class serves induction jobs over a local
+    UNIX socket, keeping datasets and blocks warm
+    in a DatasetCache between jobs. */
+
+#include "algorithm.hpp"
+#include "daemon.hpp"
+#include "threadPool.hpp"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+/* Longest request or reply line accepted. */
+#define MAX_LINE 8192
+
+/* Seconds a client may take to send its request. */
+#define REQUEST_TIMEOUT_SECONDS 10
+
+/* Fills a socket address for a path.
+   @returns False if the path is too long. */
+static bool makeAddress(string path, sockaddr_un & address){
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(address.sun_path)){
+        return false;
+    }
+    strcpy(address.sun_path, path.c_str());
+    return true;
+}
+
+/* Reads up to the first newline. */
+static string readLine(int fd){
+    string line;
+    char c;
+    while(line.size() < MAX_LINE && read(fd, &c, 1) == 1 && c != '\n'){
+        line += c;
+    }
+    return line;
+}
+
+/* Writes a whole line, retrying partial writes. */
+static void writeLine(int fd, string line){
+    line += '\n';
+    size_t written = 0;
+    while(written < line.size()){
+        ssize_t n = write(fd, line.data() + written, line.size() - written);
+        if(n <= 0){
+            return;
+        }
+        written += n;
+    }
+}
+
+Daemon::Daemon(string socketPath, size_t budgetBytes, size_t numThreads, const Options & options)
+    : m_socketPath(socketPath), m_numThreads(numThreads), m_options(options), m_cache(budgetBytes, options),
+      m_stopping(false), m_listenFd(-1), m_pool(nullptr), m_readers(0) { }
+
+bool Daemon::run(){
+    sockaddr_un address;
+    if(!makeAddress(m_socketPath, address)){
+        cerr << "Socket path too long: " << m_socketPath << endl;
+        return false;
+    }
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    // Remove a socket file left behind by a previous run
+    unlink(m_socketPath.c_str());
+    if(m_listenFd < 0 || bind(m_listenFd, (sockaddr *) &address, sizeof(address)) != 0
+       || listen(m_listenFd, 64) != 0){
+        cerr << "Unable to listen on " << m_socketPath << ": " << strerror(errno) << endl;
+        return false;
+    }
+
+    // Clients that hang up early must not kill the daemon
+    signal(SIGPIPE, SIG_IGN);
+
+    ThreadPool pool(m_numThreads);
+    m_pool = &pool;
+    // WHILE: No shutdown requested
+    while(!m_stopping){
+        int fd = accept(m_listenFd, nullptr, nullptr);
+        if(fd < 0){
+            if(errno != EINTR && !m_stopping){
+                cerr << "accept failed: " << strerror(errno) << endl;
+            }
+            continue;
+        }
+        // A client that sends nothing only holds its own reader, and only until the timeout
+        timeval timeout = {REQUEST_TIMEOUT_SECONDS, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        m_readers++;
+        thread([this, fd]{
+            serve(fd);
+            m_readers--;
+        }).detach();
+    }
+    // WHILE: Requests are still being read, they may yet queue inductions
+    while(m_readers > 0){
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    pool.wait();
+    m_pool = nullptr;
+
+    close(m_listenFd);
+    unlink(m_socketPath.c_str());
+    return true;
+}
+
+string Daemon::request(string socketPath, string line){
+    sockaddr_un address;
+    if(!makeAddress(socketPath, address)){
+        return "ERROR socket path too long";
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0 || connect(fd, (sockaddr *) &address, sizeof(address)) != 0){
+        if(fd >= 0){
+            close(fd);
+        }
+        return string("ERROR cannot connect: ") + strerror(errno);
+    }
+    writeLine(fd, line);
+    string reply = readLine(fd);
+    close(fd);
+    return reply.empty() ? "ERROR no reply" : reply;
+}
+
+void Daemon::serve(int fd){
+    istringstream buffer(readLine(fd));
+    string command, inFile, outFile;
+    buffer >> command;
+
+    if(command == "INDUCE" && buffer >> inFile >> outFile){
+        m_pool->submit([this, fd, inFile, outFile]{
+            writeLine(fd, induce(inFile, outFile));
+            close(fd);
+        });
+        return;
+    } else if(command == "STATUS"){
+        writeLine(fd, "OK " + m_cache.summary());
+    } else if(command == "SHUTDOWN"){
+        m_stopping = true;
+        writeLine(fd, "OK");
+        // Wake the accept loop; shutting down a listening socket makes accept fail
+        shutdown(m_listenFd, SHUT_RDWR);
+    } else {
+        writeLine(fd, "ERROR unknown request");
+    }
+    close(fd);
+}
+
+string Daemon::induce(string inFile, string outFile){
+    auto start = chrono::steady_clock::now();
+    bool hit = false;
+    shared_ptr<CacheEntry> entry = m_cache.get(inFile, hit);
+    if(!entry){
+        return "ERROR unable to read input file";
+    }
+
+    ofstream file(outFile);
+    if(!file){
+        return "ERROR unable to write output file";
+    }
+    Algorithm mlem2(entry->numAttributes);
+    mlem2.setSelection(m_options.selection);
+    mlem2.setSampling(m_options.sampleFraction);
+    if(m_options.speculativeSeeds > 1){
+        mlem2.setSpeculation(m_options.speculativeSeeds, m_options.numThreads);
+    }
+    if(m_options.deadlineSeconds > 0){
+        mlem2.setDeadline(start + chrono::duration_cast<chrono::steady_clock::duration>(
+                              chrono::duration<double>(m_options.deadlineSeconds)));
+    }
+    mlem2.setWeights(entry->data->getWeights());
+    mlem2.setInputCases(entry->data->getInputCases());
+    mlem2.setAVBlocks(entry->avBlocks);
+    mlem2.generateRules(file, entry->data);
+    // IF: Deadline cut induction short, mark the ruleset as partial quality
+    if(mlem2.isPartial()){
+        file << "! Partial-quality ruleset: deadline of " << m_options.deadlineSeconds
+             << " s reached; rules are valid but not minimal\n";
+    }
+    file.close();
+    // IF: Rules did not all reach the disk (e.g. it is full), the output is unusable
+    if(!file){
+        return "ERROR unable to write output file";
+    }
+
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    stringstream reply;
+    reply << "OK " << (hit ? "hit " : "miss ") << elapsed.count();
+    return reply.str();
+}
@@ -0,0 +1,64 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the daemon class.
+    @file daemon.hpp
+
+    This class serves induction jobs over a local
+    UNIX socket, keeping datasets and blocks warm
+    in a DatasetCache between jobs.
+
+    Protocol: one request line per connection, one reply line.
+        INDUCE <input> <output>  ->  OK <hit|miss> <seconds> | ERROR <reason>
+        STATUS                   ->  OK <cache summary>
+        SHUTDOWN                 ->  OK
+    Each connection's request is read on its own thread, with a
+    timeout, so idle clients never hold an induction thread. */
+
+#ifndef DAEMON_H
+#define DAEMON_H
+#include "datasetCache.hpp"
+#include "options.hpp"
+#include <atomic>
+#include <string>
+
+class ThreadPool;
+
+class Daemon {
+public:
+    /* @param options, how every job's dataset is prepared and its rules induced. */
+    Daemon(std::string socketPath, std::size_t budgetBytes, std::size_t numThreads,
+           const Options & options);
+
+    /* Accepts connections until a SHUTDOWN request arrives.
+       @returns True on clean shutdown; false if the socket cannot be opened. */
+    bool run();
+
+    /* Sends one request line to a running daemon.
+       @returns The reply line, or an ERROR line if the daemon is unreachable. */
+    static std::string request(std::string socketPath, std::string line);
+
+private:
+    std::string m_socketPath;
+    std::size_t m_numThreads;
+    Options m_options;
+    DatasetCache m_cache;
+    std::atomic<bool> m_stopping;
+    int m_listenFd;
+
+    /* Runs INDUCE requests; nullptr outside run. */
+    ThreadPool * m_pool;
+
+    /* Connections whose request is still being read. */
+    std::atomic<std::size_t> m_readers;
+
+    /* Reads one request from a connection; replies to it, or queues it
+       on the pool if it is an induction. */
+    void serve(int fd);
+
+    /* Runs one INDUCE request.
+       @returns The reply line. */
+    std::string induce(std::string inFile, std::string outFile);
+};
+#endif
@@ -9,9 +9,12 @@
     and makes access and manipulation easier. */
 
 #include "dataset.hpp"
+#include "quantileSketch.hpp"
 #include <vector>
 #include <iostream>
 #include <algorithm>
+#include <map>
+#include <numeric>
 
 using namespace std;
 
@@ -79,12 +82,18 @@ size_t Dataset::getNumCases() const {
     return m_values->getNumRows();
 }
 
-list<float> Dataset::discretize(int col, float & min, float & max){
+list<float> Dataset::discretize(int col, float & min, float & max, const set<int> * cases){
     // Convert numeric column to sorted list with no duplicates
     list<float> nums;
-    vector<Value *> casesCol = m_values->getCol(col);
+    vector<Value *> & casesCol = m_values->m_array[col];
     for(unsigned i = 0; i < casesCol.size(); i++){
-        nums.push_back(casesCol[i]->getNumValue());
+        if(!cases || cases->count(i + 1)){
+            nums.push_back(casesCol[i]->getNumValue());
+        }
+    }
+    // IF: No cases selected, there is nothing to cut
+    if(nums.empty()){
+        return list<float>();
     }
     nums.sort();
     nums.unique();
@@ -109,11 +118,243 @@ list<float> Dataset::discretize(int col, float & min, float & max){
     return cutpoints;
 }
 
-list<string> Dataset::getPossibleValues(int col){
+list<float> Dataset::discretizeBoundaries(int col, float & min, float & max, const set<int> * cases){
+    // Pair each value with its decision, sorted by value then decision
+    vector<pair<float, string>> nums;
+    vector<Value *> & casesCol = m_values->m_array[col];
+    vector<Value *> & decisionCol = m_values->m_array[m_cols - 1];
+    for(unsigned i = 0; i < casesCol.size(); i++){
+        if(!cases || cases->count(i + 1)){
+            nums.push_back(make_pair(casesCol[i]->getNumValue(), decisionCol[i]->getStrValue()));
+        }
+    }
+    // IF: No cases selected, there is nothing to cut
+    if(nums.empty()){
+        return list<float>();
+    }
+    sort(nums.begin(), nums.end());
+
+    // Set min and max for column
+    min = nums.front().first;
+    max = nums.back().first;
+
+    // FOR: Each run of equal values, cut before it unless it and the previous
+    //      run are both pure and share their decision
+    list<float> cutpoints;
+    float prevValue = 0;
+    string prevDecision;
+    bool prevPure = false;
+    for(unsigned beg = 0; beg < nums.size();){
+        unsigned end = beg;
+        while(end < nums.size() && nums[end].first == nums[beg].first){
+            end++;
+        }
+        // Decisions are sorted within the run, so it is pure if its ends match
+        bool pure = nums[beg].second == nums[end - 1].second;
+        if(beg > 0 && (!pure || !prevPure || prevDecision != nums[beg].second)){
+            cutpoints.push_back((prevValue + nums[beg].first) / 2);
+        }
+        prevValue = nums[beg].first;
+        prevDecision = nums[beg].second;
+        prevPure = pure;
+        beg = end;
+    }
+    return cutpoints;
+}
+
+list<float> Dataset::discretizeQuantiles(int col, float & min, float & max, size_t maxCutpoints,
+                                         const set<int> * cases){
+    // Stream the column into a sketch with a few bins per cutpoint
+    QuantileSketch sketch(4 * maxCutpoints < 64 ? 64 : 4 * maxCutpoints);
+    vector<Value *> & casesCol = m_values->m_array[col];
+    bool any = false;
+    // FOR: Each case in input order, which the bins depend on once they merge
+    for(size_t i : inputOrder()){
+        if(!cases || cases->count(i + 1)){
+            float value = casesCol[i]->getNumValue();
+            min = (!any || value < min) ? value : min;
+            max = (!any || value > max) ? value : max;
+            any = true;
+            sketch.add(value);
+        }
+    }
+    list<float> cutpoints;
+    // IF: No cases selected, there is nothing to cut
+    if(!any){
+        return cutpoints;
+    }
+
+    // IF: Every distinct value kept its own bin and fits the cap, use all midpoints
+    const vector<pair<double, uint64_t>> & bins = sketch.getBins();
+    if(sketch.isExact() && bins.size() - 1 <= maxCutpoints){
+        for(unsigned i = 0; i + 1 < bins.size(); i++){
+            float cur = bins[i].first, next = bins[i + 1].first;
+            cutpoints.push_back((cur + next) / 2);
+        }
+        return cutpoints;
+    }
+
+    // Otherwise, cut at equal-frequency quantiles strictly inside the range
+    for(double q : sketch.quantiles(maxCutpoints + 1)){
+        float c = q;
+        if(c > min && c < max && (cutpoints.empty() || c > cutpoints.back())){
+            cutpoints.push_back(c);
+        }
+    }
+    return cutpoints;
+}
+
+size_t Dataset::collapseDuplicates(){
+    size_t numCases = getNumCases();
+    map<vector<string>, size_t> firstCase;
+    vector<bool> keep(numCases, false);
+    vector<size_t> weights(1, 0);
+
+    // FOR: Each case, keep it if its row is new; otherwise weight the first copy
+    for(unsigned i = 0; i < numCases; i++){
+        vector<string> row;
+        for(int col = 0; col < m_cols; col++){
+            row.push_back(m_values->m_array[col][i]->getStrValue());
+        }
+        auto found = firstCase.find(row);
+        if(found == firstCase.end()){
+            firstCase[row] = weights.size();
+            weights.push_back(m_weights.empty() ? 1 : m_weights[i + 1]);
+            keep[i] = true;
+        } else {
+            weights[found->second] += m_weights.empty() ? 1 : m_weights[i + 1];
+        }
+    }
+
+    // FOR: Each column, drop the values of removed cases
+    for(int col = 0; col < m_cols; col++){
+        vector<Value *> & casesCol = m_values->m_array[col];
+        size_t kept = 0;
+        for(unsigned i = 0; i < casesCol.size(); i++){
+            if(keep[i]){
+                casesCol[kept++] = casesCol[i];
+            } else {
+                delete casesCol[i];
+            }
+        }
+        casesCol.resize(kept);
+    }
+    m_weights = weights;
+    return numCases - getNumCases();
+}
+
+const vector<size_t> * Dataset::getWeights() const {
+    return m_weights.empty() ? nullptr : &m_weights;
+}
+
+/* Orders values for renumberCases: numbers by value, before symbols by name. */
+static bool valueLess(const Value * a, const Value * b){
+    if(a->isNumeric() != b->isNumeric()){
+        return a->isNumeric();
+    }
+    return a->isNumeric() ? a->getNumValue() < b->getNumValue()
+                          : a->getStrValue() < b->getStrValue();
+}
+
+bool Dataset::renumberCases(){
+    size_t numCases = getNumCases();
+    if(numCases == 0){
+        return true;
+    }
+
+    // FOR: Each column, rank its values so cases compare by integers
+    vector<vector<size_t>> ranks(m_cols, vector<size_t>(numCases));
+    vector<size_t> numDistinct(m_cols);
+    for(int col = 0; col < m_cols; col++){
+        vector<Value *> & casesCol = m_values->m_array[col];
+        auto less = [&casesCol](size_t a, size_t b){
+            return valueLess(casesCol[a], casesCol[b]);
+        };
+        vector<size_t> byValue(numCases);
+        iota(byValue.begin(), byValue.end(), 0);
+        sort(byValue.begin(), byValue.end(), less);
+        size_t rank = 0;
+        for(size_t i = 0; i < numCases; i++){
+            if(i > 0 && less(byValue[i - 1], byValue[i])){
+                rank++;
+            }
+            ranks[col][byValue[i]] = rank;
+        }
+        numDistinct[col] = rank + 1;
+    }
+
+    // Decision first, then attributes with fewer distinct values first
+    vector<int> keys(m_cols - 1);
+    iota(keys.begin(), keys.end(), 0);
+    stable_sort(keys.begin(), keys.end(), [&numDistinct](int a, int b){
+        return numDistinct[a] < numDistinct[b];
+    });
+    keys.insert(keys.begin(), m_cols - 1);
+
+    vector<size_t> order(numCases);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&ranks, &keys](size_t a, size_t b){
+        for(int col : keys){
+            if(ranks[col][a] != ranks[col][b]){
+                return ranks[col][a] < ranks[col][b];
+            }
+        }
+        return false;
+    });
+
+    // IF: New first case would change an attribute between numeric and symbolic
+    for(int col = 0; col < m_cols; col++){
+        vector<Value *> & casesCol = m_values->m_array[col];
+        if(casesCol[order[0]]->isNumeric() != casesCol[0]->isNumeric()){
+            return false;
+        }
+    }
+
+    // FOR: Each column, move the values into the new order
+    for(int col = 0; col < m_cols; col++){
+        vector<Value *> & casesCol = m_values->m_array[col];
+        vector<Value *> moved(numCases);
+        for(size_t i = 0; i < numCases; i++){
+            moved[i] = casesCol[order[i]];
+        }
+        casesCol.swap(moved);
+    }
+
+    // Weights and input case numbers are indexed by case number
+    vector<size_t> inputCases(numCases + 1, 0);
+    for(size_t i = 0; i < numCases; i++){
+        inputCases[i + 1] = m_inputCases.empty() ? order[i] + 1 : m_inputCases[order[i] + 1];
+    }
+    if(!m_weights.empty()){
+        vector<size_t> weights(numCases + 1, 0);
+        for(size_t i = 0; i < numCases; i++){
+            weights[i + 1] = m_weights[order[i] + 1];
+        }
+        m_weights = weights;
+    }
+    m_inputCases = inputCases;
+    return true;
+}
+
+vector<size_t> Dataset::inputOrder() const {
+    vector<size_t> positions(getNumCases());
+    for(size_t i = 0; i < positions.size(); i++){
+        positions[m_inputCases.empty() ? i : m_inputCases[i + 1] - 1] = i;
+    }
+    return positions;
+}
+
+const vector<size_t> * Dataset::getInputCases() const {
+    return m_inputCases.empty() ? nullptr : &m_inputCases;
+}
+
+list<string> Dataset::getPossibleValues(int col, const set<int> * cases){
     list<string> vals;
-    vector<Value *> casesCol = m_values->getCol(col);
+    vector<Value *> & casesCol = m_values->m_array[col];
     for(unsigned i = 0; i < casesCol.size(); i++){
-        vals.push_back(casesCol[i]->getStrValue());
+        if(!cases || cases->count(i + 1)){
+            vals.push_back(casesCol[i]->getStrValue());
+        }
     }
     vals.sort();
     vals.unique();
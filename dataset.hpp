@@ -13,6 +13,7 @@
 #include "array2D.hpp"
 #include "value.hpp"
 #include <list>
+#include <set>
 #include <vector>
 #include <string>
 
@@ -31,12 +32,54 @@ public:
     std::size_t getNumCases() const;
 
     /* Performs discretization on numeric column.
+       @param cases, if given, only these cases (1-based) are considered.
        @post Min and Max are updated.
        @returns List of cutpoints. */
-    std::list<float> discretize(int col, float & min, float & max);
+    std::list<float> discretize(int col, float & min, float & max,
+                                const std::set<int> * cases = nullptr);
 
-    /* Gets the possible values for a symbolic column. */
-    std::list<std::string> getPossibleValues(int col);
+    /* Same as discretize, but only keeps cutpoints at class boundaries:
+       between neighboring values unless every case with either value
+       has the same decision. Uses one sorted pass over (value, decision).
+       @param cases, if given, only these cases (1-based) are considered. */
+    std::list<float> discretizeBoundaries(int col, float & min, float & max,
+                                          const std::set<int> * cases = nullptr);
+
+    /* Same as discretize, but caps the number of cutpoints: values are
+       streamed into a bounded quantile sketch (no sort), and cutpoints are
+       the equal-frequency quantiles. Columns with few enough distinct values
+       get the same cutpoints as discretize.
+       @param cases, if given, only these cases (1-based) are considered. */
+    std::list<float> discretizeQuantiles(int col, float & min, float & max, std::size_t maxCutpoints,
+                                         const std::set<int> * cases = nullptr);
+
+    /* Gets the possible values for a symbolic column.
+       @param cases, if given, only these cases (1-based) are considered. */
+    std::list<std::string> getPossibleValues(int col, const std::set<int> * cases = nullptr);
+
+    /* Replaces identical cases (same values, decision included) with one
+       case weighted by its multiplicity; cases are renumbered in order of
+       first occurrence.
+       @returns Number of cases removed. */
+    std::size_t collapseDuplicates();
+
+    /* Gets the multiplicity of each case, indexed by case number.
+       @returns Null if duplicates were never collapsed. */
+    const std::vector<std::size_t> * getWeights() const;
+
+    /* Reorders cases by decision value, then by attribute values, taking
+       attributes with fewer distinct values first, so each concept is a
+       range of consecutive cases and most blocks are few, long runs.
+       Weights move with their cases.
+       @returns False, leaving the order as it was, if a column mixing
+                numbers and symbols would get a first case of the other
+                kind (the first case decides if an attribute is numeric). */
+    bool renumberCases();
+
+    /* Gets the case number each case had before renumberCases, indexed by
+       case number.
+       @returns Null if cases were never renumbered. */
+    const std::vector<std::size_t> * getInputCases() const;
 
     void print() const;
 
@@ -46,5 +89,10 @@ private:
     std::string * m_attributes;
     int m_numAttributes;
     Array2D<Value *> * m_values;
+    std::vector<std::size_t> m_weights;
+    std::vector<std::size_t> m_inputCases;
+
+    /* Gets the positions of the cases in the order they were read. */
+    std::vector<std::size_t> inputOrder() const;
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,135 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the dataset cache class.
+    @file datasetCache.cpp
+
+    This class keeps parsed datasets and their
+    attribute-value blocks resident, keyed by file
+    path and modification time, and evicts the least
+    recently used entries when over a memory budget. */
+
+#include "algorithm.hpp"
+#include "datasetCache.hpp"
+#include "executive.hpp"
+#include <chrono>
+#include <sstream>
+#include <sys/stat.h>
+
+using namespace std;
+
+/* Approximate heap cost of one std::set<int> node. */
+#define SET_NODE_BYTES 48
+
+CacheEntry::~CacheEntry(){
+    for(AV * av : avBlocks){
+        delete av;
+    }
+    delete data;
+}
+
+shared_ptr<CacheEntry> DatasetCache::get(string filename, bool & hit){
+    hit = false;
+    struct stat info;
+    if(stat(filename.c_str(), &info) != 0){
+        return nullptr;
+    }
+    stringstream stamp;
+    stamp << info.st_mtim.tv_sec << "." << info.st_mtim.tv_nsec << ":" << info.st_size;
+
+    promise<shared_ptr<CacheEntry>> building;
+    Pending pending;
+    {
+        lock_guard<mutex> guard(m_lock);
+        auto found = m_index.find(filename);
+        // IF: File is resident (or being built) and unchanged, move it to the front
+        if(found != m_index.end() && found->second->stamp == stamp.str()){
+            m_slots.splice(m_slots.begin(), m_slots, found->second);
+            m_hits++;
+            hit = true;
+            pending = found->second->entry;
+        } else {
+            // IF: File changed since it was cached, drop the stale entry
+            if(found != m_index.end()){
+                m_bytes -= found->second->bytes;
+                m_slots.erase(found->second);
+                m_index.erase(found);
+            }
+            m_misses++;
+            m_slots.push_front({filename, stamp.str(), building.get_future().share(), 0});
+            m_index[filename] = m_slots.begin();
+        }
+    }
+    // IF: Hit, wait (outside the lock) for the entry in case it is still being built
+    if(hit){
+        return pending.get();
+    }
+
+    shared_ptr<CacheEntry> entry = build(filename, m_options);
+    building.set_value(entry);
+
+    lock_guard<mutex> guard(m_lock);
+    auto found = m_index.find(filename);
+    if(found != m_index.end() && found->second->stamp == stamp.str()){
+        // IF: File could not be read, forget it
+        if(!entry){
+            m_slots.erase(found->second);
+            m_index.erase(found);
+        } else {
+            found->second->bytes = entry->bytes;
+            m_bytes += entry->bytes;
+        }
+    }
+    evict();
+    return entry;
+}
+
+string DatasetCache::summary(){
+    lock_guard<mutex> guard(m_lock);
+    stringstream stream;
+    stream << "entries " << m_slots.size() << " bytes " << m_bytes << " budget " << m_budget
+           << " hits " << m_hits << " misses " << m_misses << " evictions " << m_evictions;
+    return stream.str();
+}
+
+shared_ptr<CacheEntry> DatasetCache::build(string filename, const Options & options){
+    Executive exec;
+    exec.setOptions(options);
+    if(!exec.parseInFile(filename)){
+        return nullptr;
+    }
+    shared_ptr<CacheEntry> entry(new CacheEntry());
+    entry->numAttributes = exec.getNumAttributes();
+    entry->data = exec.releaseDataset();
+
+    Algorithm mlem2(entry->numAttributes);
+    mlem2.setCutpointMode(options.cutpointMode, options.maxCutpoints);
+    mlem2.setWeights(entry->data->getWeights());
+    mlem2.setInputCases(entry->data->getInputCases());
+    mlem2.generateAVBlocks(entry->data);
+    entry->avBlocks = mlem2.getAVBlocks();
+
+    // Estimate resident size: one Value per cell plus one set node per block member
+    entry->bytes = entry->data->getNumCases() * (entry->numAttributes + 1) * (sizeof(Value) + sizeof(Value *));
+    for(AV * av : entry->avBlocks){
+        entry->bytes += sizeof(AVNumeric) + av->size() * SET_NODE_BYTES;
+    }
+    return entry;
+}
+
+void DatasetCache::evict(){
+    auto iter = m_slots.end();
+    // WHILE: Over budget and older slots remain
+    while(m_bytes > m_budget && iter != m_slots.begin()){
+        iter--;
+        // IF: Slot is still being built, skip it
+        if(iter->entry.wait_for(chrono::seconds(0)) != future_status::ready){
+            continue;
+        }
+        m_bytes -= iter->bytes;
+        m_evictions++;
+        m_index.erase(iter->filename);
+        iter = m_slots.erase(iter);
+    }
+}
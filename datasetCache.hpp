@@ -0,0 +1,83 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the dataset cache class.
+    @file datasetCache.hpp
+
+    This class keeps parsed datasets and their
+    attribute-value blocks resident, keyed by file
+    path and modification time, and evicts the least
+    recently used entries when over a memory budget. */
+
+#ifndef DATASET_CACHE_H
+#define DATASET_CACHE_H
+#include "av.hpp"
+#include "dataset.hpp"
+#include "options.hpp"
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* A parsed dataset with its attribute-value blocks. Read-only once built,
+   so any number of jobs may induce from it at the same time. */
+struct CacheEntry {
+    Dataset * data;
+    std::size_t numAttributes;
+    std::vector<AV *> avBlocks;
+    std::size_t bytes;
+
+    CacheEntry() : data(nullptr), numAttributes(0), bytes(0) { }
+    ~CacheEntry();
+};
+
+class DatasetCache {
+public:
+    /* @param options, duplicate collapsing, case order and cutpoints to build entries with. */
+    DatasetCache(std::size_t budgetBytes, const Options & options)
+        : m_budget(budgetBytes), m_options(options), m_bytes(0), m_hits(0), m_misses(0), m_evictions(0) { }
+
+    /* Gets the entry for a file, parsing it and building blocks on a miss.
+       Concurrent requests for the same file share one build.
+       @param hit, set to true if the entry was already resident.
+       @returns nullptr if the file cannot be read. */
+    std::shared_ptr<CacheEntry> get(std::string filename, bool & hit);
+
+    /* Gets "entries bytes budget hits misses evictions" as one line. */
+    std::string summary();
+
+private:
+    typedef std::shared_future<std::shared_ptr<CacheEntry>> Pending;
+
+    struct Slot {
+        std::string filename;
+        std::string stamp;
+        Pending entry;
+        std::size_t bytes;
+    };
+
+    std::size_t m_budget;
+    Options m_options;
+    std::size_t m_bytes;
+    std::size_t m_hits;
+    std::size_t m_misses;
+    std::size_t m_evictions;
+
+    /* Most recently used first. */
+    std::list<Slot> m_slots;
+    std::map<std::string, std::list<Slot>::iterator> m_index;
+    std::mutex m_lock;
+
+    /* Parses a file and builds its blocks.
+       @returns nullptr if the file cannot be read. */
+    static std::shared_ptr<CacheEntry> build(std::string filename, const Options & options);
+
+    /* Drops least recently used built entries until within budget.
+       Entries still in use stay alive until their jobs finish. */
+    void evict();
+};
+#endif
@@ -0,0 +1,378 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the binary dataset snapshot.
+    @file datasetSnapshot.cpp
+
+    A parsed and preprocessed dataset laid out as flat
+    arrays, so a run on an unchanged input can map it
+    instead of parsing, discretizing and building blocks. */
+
+#include "avNumeric.hpp"
+#include "avSymbolic.hpp"
+#include "datasetSnapshot.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/* Rounds a section offset up to 8 bytes. */
+static uint64_t align8(uint64_t offset){
+    return (offset + 7) & ~(uint64_t) 7;
+}
+
+/* Adds a string to a dictionary once.
+   @returns Offset of the string. */
+static uint32_t addString(string & strings, map<string, uint32_t> & index, string str){
+    auto found = index.find(str);
+    if(found != index.end()){
+        return found->second;
+    }
+    uint32_t offset = strings.size();
+    strings += str;
+    strings += '\0';
+    index[str] = offset;
+    return offset;
+}
+
+DatasetSnapshot::~DatasetSnapshot(){
+    close();
+}
+
+bool DatasetSnapshot::write(string filename, uint64_t sourceSize, uint64_t sourceChecksum, uint64_t datasetHash,
+                            const Options & options, Dataset * data, size_t numAttributes,
+                            const vector<AV *> & avBlocks, const vector<Concept *> & concepts){
+    string strings;
+    map<string, uint32_t> index;
+    size_t numCases = data->getNumCases();
+    vector<SnapshotAttribute> attributes(numAttributes + 1);
+    vector<float> cutpoints;
+    vector<uint32_t> cells((numAttributes + 1) * numCases);
+    vector<SnapshotBlock> blocks;
+    vector<SnapshotConcept> conceptRecords;
+    vector<uint32_t> members;
+
+    // FOR: Each column, record its name and its cells as dictionary offsets
+    for(unsigned col = 0; col <= numAttributes; col++){
+        SnapshotAttribute & attribute = attributes[col];
+        attribute.name = addString(strings, index, col < numAttributes ? data->getAttribute(col)
+                                                                       : data->getDecision());
+        attribute.numeric = col < numAttributes && numCases > 0 && data->getValue(1, col)->isNumeric();
+        attribute.firstCutpoint = attribute.numCutpoints = 0;
+        attribute.min = attribute.max = 0;
+        for(unsigned r = 1; r <= numCases; r++){
+            cells[col * numCases + r - 1] = addString(strings, index, data->getValue(r, col)->getStrValue());
+        }
+    }
+
+    vector<size_t> numericBlocks(numAttributes + 1, 0);
+    // FOR: Each block, record it and its cases
+    for(AV * av : avBlocks){
+        SnapshotBlock block;
+        block.attribute = av->getAttrCol();
+        block.value = 0;
+        block.min = block.max = 0;
+        if(av->isNumeric()){
+            block.min = ((AVNumeric *) av)->getLowerBound();
+            block.max = ((AVNumeric *) av)->getUpperBound();
+
+            // Blocks come in (min..c, c..max) pairs, one pair per cutpoint
+            SnapshotAttribute & attribute = attributes[block.attribute];
+            if(numericBlocks[block.attribute]++ % 2 == 0){
+                if(attribute.numCutpoints == 0){
+                    attribute.firstCutpoint = cutpoints.size();
+                }
+                cutpoints.push_back(block.max);
+                attribute.numCutpoints++;
+                attribute.min = block.min;
+            } else {
+                attribute.max = block.max;
+            }
+        } else {
+            block.value = addString(strings, index, ((AVSymbolic *) av)->getValue());
+        }
+        set<int> cases = av->getBlock();
+        block.firstMember = members.size();
+        block.size = cases.size();
+        members.insert(members.end(), cases.begin(), cases.end());
+        blocks.push_back(block);
+    }
+
+    // FOR: Each concept, record its value and its cases
+    for(Concept * concept : concepts){
+        SnapshotConcept record;
+        record.value = addString(strings, index, concept->getValue());
+        record.reserved = 0;
+        set<int> cases = concept->getBlock();
+        record.firstMember = members.size();
+        record.size = cases.size();
+        members.insert(members.end(), cases.begin(), cases.end());
+        conceptRecords.push_back(record);
+    }
+
+    vector<uint64_t> weights;
+    if(data->getWeights()){
+        weights.assign(data->getWeights()->begin(), data->getWeights()->end());
+    }
+    vector<uint64_t> inputCases;
+    if(data->getInputCases()){
+        inputCases.assign(data->getInputCases()->begin(), data->getInputCases()->end());
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    strncpy(header.magic, DATASET_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = DATASET_SNAPSHOT_VERSION;
+    header.numAttributes = numAttributes;
+    header.numCases = numCases;
+    header.numCutpoints = cutpoints.size();
+    header.numBlocks = blocks.size();
+    header.numConcepts = conceptRecords.size();
+    header.cutpointMode = options.cutpointMode;
+    header.collapsed = data->getWeights() != nullptr;
+    header.renumbered = options.renumberCases;
+    header.maxCutpoints = options.maxCutpoints;
+    header.sourceSize = sourceSize;
+    header.sourceChecksum = sourceChecksum;
+    header.datasetHash = datasetHash;
+    header.numMembers = members.size();
+    header.numWeights = weights.size();
+    header.numInputCases = inputCases.size();
+    header.stringsSize = strings.size();
+    header.attributesOffset = align8(sizeof(header));
+    header.cutpointsOffset = align8(header.attributesOffset + attributes.size() * sizeof(SnapshotAttribute));
+    header.cellsOffset = align8(header.cutpointsOffset + cutpoints.size() * sizeof(float));
+    header.blocksOffset = align8(header.cellsOffset + cells.size() * sizeof(uint32_t));
+    header.conceptsOffset = align8(header.blocksOffset + blocks.size() * sizeof(SnapshotBlock));
+    header.membersOffset = align8(header.conceptsOffset + conceptRecords.size() * sizeof(SnapshotConcept));
+    header.weightsOffset = align8(header.membersOffset + members.size() * sizeof(uint32_t));
+    header.inputCasesOffset = align8(header.weightsOffset + weights.size() * sizeof(uint64_t));
+    header.stringsOffset = align8(header.inputCasesOffset + inputCases.size() * sizeof(uint64_t));
+
+    // Write to a temporary file and rename, so readers never map a partial file
+    string tmpName = filename + ".tmp";
+    ofstream file(tmpName, ios::binary);
+    if(!file){
+        return false;
+    }
+    auto section = [&file](uint64_t offset, const void * data, size_t bytes){
+        static const char padding[8] = {0};
+        file.write(padding, offset - file.tellp());
+        file.write((const char *) data, bytes);
+    };
+    file.write((const char *) &header, sizeof(header));
+    section(header.attributesOffset, attributes.data(), attributes.size() * sizeof(SnapshotAttribute));
+    section(header.cutpointsOffset, cutpoints.data(), cutpoints.size() * sizeof(float));
+    section(header.cellsOffset, cells.data(), cells.size() * sizeof(uint32_t));
+    section(header.blocksOffset, blocks.data(), blocks.size() * sizeof(SnapshotBlock));
+    section(header.conceptsOffset, conceptRecords.data(), conceptRecords.size() * sizeof(SnapshotConcept));
+    section(header.membersOffset, members.data(), members.size() * sizeof(uint32_t));
+    section(header.weightsOffset, weights.data(), weights.size() * sizeof(uint64_t));
+    section(header.inputCasesOffset, inputCases.data(), inputCases.size() * sizeof(uint64_t));
+    section(header.stringsOffset, strings.data(), strings.size());
+    file.close();
+    if(!file || rename(tmpName.c_str(), filename.c_str()) != 0){
+        unlink(tmpName.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool DatasetSnapshot::open(string filename){
+    close();
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd < 0){
+        return false;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(SnapshotHeader)){
+        ::close(fd);
+        return false;
+    }
+    void * base = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(base == MAP_FAILED){
+        return false;
+    }
+    m_base = (const char *) base;
+    m_length = info.st_size;
+
+    // Check the header, then that every section lies inside the file
+    const SnapshotHeader & h = header();
+    bool valid = memcmp(h.magic, DATASET_SNAPSHOT_MAGIC, sizeof(DATASET_SNAPSHOT_MAGIC)) == 0
+                 && h.version == DATASET_SNAPSHOT_VERSION;
+    auto inside = [this](uint64_t offset, uint64_t count, uint64_t size){
+        return offset % 8 == 0 && offset <= m_length && count <= (m_length - offset) / size;
+    };
+    valid = valid && inside(h.attributesOffset, (uint64_t) h.numAttributes + 1, sizeof(SnapshotAttribute))
+                  && inside(h.cutpointsOffset, h.numCutpoints, sizeof(float))
+                  && inside(h.cellsOffset, ((uint64_t) h.numAttributes + 1) * h.numCases, sizeof(uint32_t))
+                  && inside(h.blocksOffset, h.numBlocks, sizeof(SnapshotBlock))
+                  && inside(h.conceptsOffset, h.numConcepts, sizeof(SnapshotConcept))
+                  && inside(h.membersOffset, h.numMembers, sizeof(uint32_t))
+                  && inside(h.weightsOffset, h.numWeights, sizeof(uint64_t))
+                  && inside(h.inputCasesOffset, h.numInputCases, sizeof(uint64_t))
+                  && inside(h.stringsOffset, h.stringsSize, 1)
+                  && (h.stringsSize == 0 || m_base[h.stringsOffset + h.stringsSize - 1] == '\0');
+
+    // Check that records refer inside their sections; cells are checked on use
+    const SnapshotAttribute * attributes = (const SnapshotAttribute *) (m_base + h.attributesOffset);
+    for(uint32_t col = 0; valid && col <= h.numAttributes; col++){
+        valid = attributes[col].name < h.stringsSize;
+    }
+    const SnapshotBlock * blocks = (const SnapshotBlock *) (m_base + h.blocksOffset);
+    for(uint32_t i = 0; valid && i < h.numBlocks; i++){
+        valid = blocks[i].attribute < h.numAttributes && blocks[i].value < h.stringsSize
+                && blocks[i].firstMember <= h.numMembers && blocks[i].size <= h.numMembers - blocks[i].firstMember;
+    }
+    const SnapshotConcept * concepts = (const SnapshotConcept *) (m_base + h.conceptsOffset);
+    for(uint32_t i = 0; valid && i < h.numConcepts; i++){
+        valid = concepts[i].value < h.stringsSize && concepts[i].firstMember <= h.numMembers
+                && concepts[i].size <= h.numMembers - concepts[i].firstMember;
+    }
+    // Members and weights are indexed by case number, so members must be cases
+    const uint32_t * members = (const uint32_t *) (m_base + h.membersOffset);
+    for(uint64_t m = 0; valid && m < h.numMembers; m++){
+        valid = members[m] >= 1 && members[m] <= h.numCases;
+    }
+    valid = valid && (h.numWeights == 0 || h.numWeights == (uint64_t) h.numCases + 1);
+    // Case numbers before renumbering index checkpoints; they must be cases
+    const uint64_t * inputCases = (const uint64_t *) (m_base + h.inputCasesOffset);
+    valid = valid && (h.numInputCases == 0 || h.numInputCases == (uint64_t) h.numCases + 1);
+    for(uint64_t x = 1; valid && x < h.numInputCases; x++){
+        valid = inputCases[x] >= 1 && inputCases[x] <= h.numCases;
+    }
+    if(!valid){
+        close();
+        return false;
+    }
+
+    const uint64_t * weights = (const uint64_t *) (m_base + h.weightsOffset);
+    m_weights.assign(weights, weights + h.numWeights);
+    m_inputCases.assign(inputCases, inputCases + h.numInputCases);
+    return true;
+}
+
+bool DatasetSnapshot::matchesSource(uint64_t size, uint64_t checksum) const {
+    return m_base && header().sourceSize == size && header().sourceChecksum == checksum;
+}
+
+uint64_t DatasetSnapshot::getDatasetHash() const {
+    return m_base ? header().datasetHash : 0;
+}
+
+bool DatasetSnapshot::matchesOptions(const Options & options) const {
+    return m_base && header().cutpointMode == (uint32_t) options.cutpointMode
+           && header().maxCutpoints == options.maxCutpoints
+           && (header().collapsed != 0) == options.collapseDuplicates
+           && (header().renumbered != 0) == options.renumberCases;
+}
+
+bool DatasetSnapshot::isCollapsed() const {
+    return m_base && header().collapsed != 0;
+}
+
+bool DatasetSnapshot::isRenumbered() const {
+    return m_base && header().numInputCases != 0;
+}
+
+size_t DatasetSnapshot::getNumAttributes() const {
+    return header().numAttributes;
+}
+
+Dataset * DatasetSnapshot::loadDataset() const {
+    Dataset * data = loadSchema();
+    const uint32_t * cells = (const uint32_t *) (m_base + header().cellsOffset);
+    size_t numCases = header().numCases;
+    // FOR: Each case, add its values in file order
+    for(size_t r = 0; r < numCases; r++){
+        for(unsigned col = 0; col <= header().numAttributes; col++){
+            uint32_t cell = cells[col * numCases + r];
+            data->addValue(col, cell < header().stringsSize ? getString(cell) : "");
+        }
+    }
+    return data;
+}
+
+Dataset * DatasetSnapshot::loadSchema() const {
+    const SnapshotAttribute * attributes = (const SnapshotAttribute *) (m_base + header().attributesOffset);
+    Dataset * data = new Dataset(header().numAttributes + 1);
+    for(unsigned col = 0; col < header().numAttributes; col++){
+        data->addAttribute(getString(attributes[col].name));
+    }
+    data->setDecision(getString(attributes[header().numAttributes].name));
+    return data;
+}
+
+vector<AV *> DatasetSnapshot::loadAVBlocks() const {
+    const SnapshotAttribute * attributes = (const SnapshotAttribute *) (m_base + header().attributesOffset);
+    const SnapshotBlock * blocks = (const SnapshotBlock *) (m_base + header().blocksOffset);
+    const uint32_t * members = (const uint32_t *) (m_base + header().membersOffset);
+    vector<AV *> avBlocks;
+    avBlocks.reserve(header().numBlocks);
+
+    // FOR: Each block, rebuild it with its cases (sorted, so the set is built in linear time)
+    for(uint32_t i = 0; i < header().numBlocks; i++){
+        const SnapshotBlock & block = blocks[i];
+        string attr = getString(attributes[block.attribute].name);
+        AV * av = nullptr;
+        if(attributes[block.attribute].numeric){
+            av = new AVNumeric(attr, block.attribute, block.min, block.max);
+        } else {
+            av = new AVSymbolic(attr, block.attribute, getString(block.value));
+        }
+        const uint32_t * first = members + block.firstMember;
+        av->setBlock(set<int>(first, first + block.size));
+        avBlocks.push_back(av);
+    }
+    return avBlocks;
+}
+
+vector<Concept *> DatasetSnapshot::loadConcepts() const {
+    const SnapshotAttribute * attributes = (const SnapshotAttribute *) (m_base + header().attributesOffset);
+    const SnapshotConcept * records = (const SnapshotConcept *) (m_base + header().conceptsOffset);
+    const uint32_t * members = (const uint32_t *) (m_base + header().membersOffset);
+    string decision = getString(attributes[header().numAttributes].name);
+    vector<Concept *> concepts;
+
+    for(uint32_t i = 0; i < header().numConcepts; i++){
+        Concept * concept = new Concept(decision, getString(records[i].value));
+        for(uint64_t m = 0; m < records[i].size; m++){
+            concept->addCase(members[records[i].firstMember + m]);
+        }
+        concepts.push_back(concept);
+    }
+    return concepts;
+}
+
+const vector<size_t> * DatasetSnapshot::getWeights() const {
+    return isCollapsed() ? &m_weights : nullptr;
+}
+
+const vector<size_t> * DatasetSnapshot::getInputCases() const {
+    return isRenumbered() ? &m_inputCases : nullptr;
+}
+
+const SnapshotHeader & DatasetSnapshot::header() const {
+    return *(const SnapshotHeader *) m_base;
+}
+
+const char * DatasetSnapshot::getString(uint32_t offset) const {
+    return m_base + header().stringsOffset + offset;
+}
+
+void DatasetSnapshot::close(){
+    if(m_base){
+        munmap((void *) m_base, m_length);
+    }
+    m_base = nullptr;
+    m_length = 0;
+    m_weights.clear();
+    m_inputCases.clear();
+}
@@ -0,0 +1,171 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the binary dataset snapshot.
+    @file datasetSnapshot.hpp
+
+    A parsed and preprocessed dataset laid out as flat
+    arrays, so a run on an unchanged input can map it
+    instead of parsing, discretizing and building blocks.
+    The source file's size and checksum are recorded, and
+    a snapshot of any other contents is stale. The hash of
+    the parsed tokens is kept too, as the result cache's
+    dataset key.
+
+    Layout (native byte order, every section 8-byte aligned):
+        header
+        attributes[numAttributes + 1]  (decision last)
+        cutpoints[numCutpoints]        (numeric attributes, in order)
+        cells[(numAttributes + 1) * numCases]
+                                       (column-major dictionary offsets)
+        blocks[numBlocks]              (attribute-value blocks, in index order)
+        concepts[numConcepts]
+        members[numMembers]            (case numbers of blocks, then concepts)
+        weights[numWeights]            (case multiplicities; none unless collapsed)
+        inputCases[numInputCases]      (case numbers before renumbering; none unless renumbered)
+        strings[stringsSize]           (dictionary of NUL-terminated names and values) */
+
+#ifndef DATASET_SNAPSHOT_H
+#define DATASET_SNAPSHOT_H
+#include "av.hpp"
+#include "concept.hpp"
+#include "dataset.hpp"
+#include "options.hpp"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#define DATASET_SNAPSHOT_MAGIC "MLEM2DS"
+#define DATASET_SNAPSHOT_VERSION 3
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t numAttributes;
+    std::uint32_t numCases;
+    std::uint32_t numCutpoints;
+    std::uint32_t numBlocks;
+    std::uint32_t numConcepts;
+    std::uint32_t cutpointMode;
+    std::uint32_t collapsed;
+    std::uint32_t renumbered;
+    std::uint32_t reserved;
+    std::uint64_t maxCutpoints;
+    std::uint64_t sourceSize;
+    std::uint64_t sourceChecksum;
+    std::uint64_t datasetHash;
+    std::uint64_t numMembers;
+    std::uint64_t numWeights;
+    std::uint64_t numInputCases;
+    std::uint64_t stringsSize;
+    std::uint64_t attributesOffset;
+    std::uint64_t cutpointsOffset;
+    std::uint64_t cellsOffset;
+    std::uint64_t blocksOffset;
+    std::uint64_t conceptsOffset;
+    std::uint64_t membersOffset;
+    std::uint64_t weightsOffset;
+    std::uint64_t inputCasesOffset;
+    std::uint64_t stringsOffset;
+};
+
+struct SnapshotAttribute {
+    std::uint32_t name;
+    std::uint32_t numeric;
+    std::uint32_t firstCutpoint;
+    std::uint32_t numCutpoints;
+    float min;
+    float max;
+};
+
+struct SnapshotBlock {
+    std::uint32_t attribute;
+    /* Symbolic value (string offset); unused for numeric blocks. */
+    std::uint32_t value;
+    float min;
+    float max;
+    std::uint64_t firstMember;
+    std::uint64_t size;
+};
+
+struct SnapshotConcept {
+    std::uint32_t value;
+    std::uint32_t reserved;
+    std::uint64_t firstMember;
+    std::uint64_t size;
+};
+
+/* A read-only, memory-mapped dataset snapshot. */
+class DatasetSnapshot {
+public:
+    DatasetSnapshot() : m_base(nullptr), m_length(0) { }
+    ~DatasetSnapshot();
+    DatasetSnapshot(const DatasetSnapshot &) = delete;
+    DatasetSnapshot & operator=(const DatasetSnapshot &) = delete;
+
+    /* Writes a snapshot of a dataset, its blocks (built with the given
+       options) and its concepts.
+       @param datasetHash, hash of the parsed tokens; 0 if unknown.
+       @returns True if file write is successful; false, otherwise. */
+    static bool write(std::string filename, std::uint64_t sourceSize, std::uint64_t sourceChecksum,
+                      std::uint64_t datasetHash,
+                      const Options & options, Dataset * data, std::size_t numAttributes,
+                      const std::vector<AV *> & avBlocks, const std::vector<Concept *> & concepts);
+
+    /* Maps a file and checks its header and section bounds.
+       @returns True if the file is a valid snapshot; false, otherwise. */
+    bool open(std::string filename);
+
+    /* Checks if the snapshot was taken of a source with this size and checksum. */
+    bool matchesSource(std::uint64_t size, std::uint64_t checksum) const;
+
+    /* Gets the hash of the parsed tokens of the source; 0 if unknown. */
+    std::uint64_t getDatasetHash() const;
+
+    /* Checks if the blocks were built the way these options would build them. */
+    bool matchesOptions(const Options & options) const;
+
+    /* Checks if the cells are of a dataset with duplicate cases collapsed. */
+    bool isCollapsed() const;
+
+    /* Checks if the cells are of a dataset with renumbered cases. */
+    bool isRenumbered() const;
+
+    std::size_t getNumAttributes() const;
+
+    /* Rebuilds the dataset from the cells; no text is tokenized. */
+    Dataset * loadDataset() const;
+
+    /* Builds a dataset with the attribute and decision names only,
+       for runs that take blocks and concepts from the snapshot. */
+    Dataset * loadSchema() const;
+
+    /* Builds the attribute-value blocks, in index order. */
+    std::vector<AV *> loadAVBlocks() const;
+
+    /* Builds the concepts, in the order generateConcepts gives them. */
+    std::vector<Concept *> loadConcepts() const;
+
+    /* Gets the multiplicity of each case.
+       @returns Null if the snapshot is not collapsed. */
+    const std::vector<std::size_t> * getWeights() const;
+
+    /* Gets the case number of each case before renumbering.
+       @returns Null if the snapshot is not renumbered. */
+    const std::vector<std::size_t> * getInputCases() const;
+
+private:
+    const char * m_base;
+    std::size_t m_length;
+    std::vector<std::size_t> m_weights;
+    std::vector<std::size_t> m_inputCases;
+
+    const SnapshotHeader & header() const;
+    const char * getString(std::uint32_t offset) const;
+
+    /* Frees the mapping, if any. */
+    void close();
+};
+#endif
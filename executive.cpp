@@ -9,15 +9,44 @@
     of the program. */
 
 #include "algorithm.hpp"
+#include "crossValidation.hpp"
 #include "executive.hpp"
+#include "incrementalRuleset.hpp"
+#include "inputStream.hpp"
+#include "memTracker.hpp"
+#include "shardCoordinator.hpp"
+#include "trace.hpp"
+#include <chrono>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
 using namespace std;
 
+/* Size of the output file buffer. */
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+
+/* Gets the command-line name of a cutpoint mode. */
+static string cutpointModeName(CutpointMode mode){
+    switch(mode){
+        case CUT_BOUNDARY: return "boundary";
+        case CUT_QUANTILE: return "quantile";
+        default: return "all";
+    }
+}
+
 Executive::Executive(){
+    m_data = nullptr;
     m_numAttributes = 0;
+    m_stats = nullptr;
+    m_snapshotBlocks = false;
+    m_sourceSize = 0;
+    m_sourceChecksum = 0;
+    m_datasetHash = 0;
+    m_hashed = false;
+    m_resultCache = nullptr;
+    m_start = chrono::steady_clock::now();
+    m_partial = false;
 }
 
 Executive::~Executive(){
@@ -25,7 +54,14 @@ Executive::~Executive(){
 }
 
 bool Executive::parseInFile(string filename) {
-    fstream file;
+    m_sourceFile = filename;
+    m_start = chrono::steady_clock::now();
+    // IF: Snapshot of the same contents exists, skip parsing
+    if(keepsSnapshot() && loadSnapshot(filename)){
+        return true;
+    }
+
+    InputStream file;
     file.open(filename);
 
     // Unable to open file; Signal with boolean
@@ -33,39 +69,58 @@ bool Executive::parseInFile(string filename) {
         return false;
     }
 
+    ScopedTimer timer(m_stats, PHASE_PARSE);
+    MemScope memScope(MEM_DATASET);
+    TraceSpan span("parse", filename);
     parseFormat(file);
     m_data = new Dataset(m_numAttributes + 1);
+    m_datasetHash = hashString(to_string(m_numAttributes));
+    m_hashed = false;
     parseHeader(file);
 
     string word;
     unsigned col = 0;
-    while(file >> word){
+    while(nextValue(file, word)){
         // IF: col is at last column, reset col
         if(col == m_numAttributes + 1){
             col = 0;
         }
-        size_t pos = word.find('!');
-        if(pos != string::npos){
-            if(pos != 0){
-                word = word.erase(pos);
-            } else {
-                word = "";
-            }         
-            string comment;
-            getline(file, comment, '\n');
-        }
-        if(!word.empty()){
-            m_data->addValue(col, word);
-            col++;
-        }  
+        m_data->addValue(col, word);
+        m_datasetHash = hashString(word, m_datasetHash);
+        col++;
     }
-
-    file.close();
+    // IF: Input ended early (e.g. truncated archive), its cases are incomplete
+    if(!file.getError().empty()){
+        cerr << "Unable to read " << filename << ": " << file.getError() << endl;
+        delete m_data;
+        m_data = nullptr;
+        return false;
+    }
+    m_hashed = true;
+    prepareCases(filename);
     return true;
 }
 
+void Executive::prepareCases(string filename){
+    // IF: Cross-validation and appending need every case, in input order
+    if(m_options.cvFolds > 0 || !m_options.appendFile.empty()){
+        return;
+    }
+    if(m_options.collapseDuplicates){
+        size_t removed = m_data->collapseDuplicates();
+        cout << "Collapsed " << removed << " duplicate cases of " << filename << endl;
+    }
+    if(m_options.renumberCases && !m_data->renumberCases()){
+        cerr << "Keeping case order of " << filename
+             << ": renumbering would change which attributes are numeric" << endl;
+    }
+}
+
 bool Executive::generateOutFile(string filename){
+    // Rules are streamed concept by concept through a large buffer
+    vector<char> buffer(OUTPUT_BUFFER_SIZE);
     ofstream file;
+    file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
     file.open(filename);
 
     // Unable to open file; Signal with boolean
@@ -73,13 +128,482 @@ bool Executive::generateOutFile(string filename){
         return false;
     }
 
-    Algorithm mlem2(m_numAttributes);
-    mlem2.generateRuleset(file, m_data);
+    m_lastError.clear();
+    m_partial = false;
+
+    // IF: Same dataset was induced with the same options before, reuse its rules
+    if(cachesResult()){
+        uint64_t key = ResultCache::makeKey(m_datasetHash, m_options);
+        if(m_resultCache->fetch(key, file)){
+            if(m_stats){
+                m_stats->count(COUNT_RESULT_CACHE_HITS);
+            }
+            cout << "Result cache hit for " << filename << endl;
+            file.close();
+            return true;
+        }
+        if(m_stats){
+            m_stats->count(COUNT_RESULT_CACHE_MISSES);
+        }
+    }
+
+    // IF: Cross-validating, report error rates instead of writing rules
+    if(m_options.cvFolds > 0){
+        CrossValidation cv(m_data, m_numAttributes, m_options.cvFolds,
+                           m_options.cutpointMode, m_options.maxCutpoints);
+        cv.run(m_options.cvCutpoints, m_options.numThreads);
+        cv.report(file);
+        file.close();
+        return true;
+    }
+
+    // IF: Appending cases or verifying, keep the coverings to repair or check them
+    if(!m_options.appendFile.empty() || m_options.verify){
+        generateIncremental(file);
+        file.close();
+        return true;
+    }
+
+    // IF: Spreading concepts over worker processes
+    if(m_options.numWorkers > 1){
+        generateSharded(file, filename);
+        file.close();
+        storeResult(filename);
+        return true;
+    }
+
+    // IF: Comparing cutpoint modes, run with all cutpoints first and report
+    if(m_options.compareCutpoints){
+        compareCutpoints(file);
+        file.close();
+        return true;
+    }
+
+    // IF: Comparing speculative induction, run one rule at a time first and report
+    if(m_options.compareSpeculation && m_options.speculativeSeeds > 1){
+        compareSpeculation(file);
+        file.close();
+        return true;
+    }
+
+    BinaryRulesetWriter binary(m_data, m_numAttributes);
+    Algorithm mlem2(m_numAttributes, m_stats);
+    mlem2.setCutpointMode(m_options.cutpointMode, m_options.maxCutpoints);
+    mlem2.setSelection(m_options.selection);
+    mlem2.setSampling(m_options.sampleFraction);
+    if(m_options.binaryRules){
+        mlem2.setRulesetWriter(&binary);
+    }
+
+    // IF: Out-of-core blocks requested, give the algorithm a scratch block store
+    BlockStore store(m_data->getNumCases(), m_options.blockStoreMB << 20);
+    bool stored = !m_options.blockStoreDir.empty() && !m_snapshotBlocks;
+    if(stored && !store.create(m_options.blockStoreDir)){
+        cerr << "Unable to create block store in " << m_options.blockStoreDir
+             << "; keeping blocks in memory" << endl;
+        stored = false;
+    }
+    if(stored){
+        mlem2.setBlockStore(&store);
+    }
+
+    // IF: Speculating, blocks must be in memory; store lookups are not thread-safe
+    bool speculate = m_options.speculativeSeeds > 1;
+    if(speculate && stored){
+        cerr << "Speculative induction needs blocks in memory; building one rule at a time" << endl;
+        speculate = false;
+    }
+    if(speculate){
+        mlem2.setSpeculation(m_options.speculativeSeeds, m_options.numThreads);
+    }
+    if(m_options.deadlineSeconds > 0){
+        mlem2.setDeadline(m_start + chrono::duration_cast<chrono::steady_clock::duration>(
+                              chrono::duration<double>(m_options.deadlineSeconds)));
+    }
+
+    vector<Concept *> concepts;
+    // IF: Snapshot holds blocks built with these options, use them as they are
+    if(m_snapshotBlocks){
+        ScopedTimer timer(m_stats, PHASE_BLOCKS);
+        mlem2.setWeights(m_snapshot.getWeights());
+        mlem2.setInputCases(m_snapshot.getInputCases());
+        mlem2.setAVBlocks(m_snapshot.loadAVBlocks());
+        concepts = m_snapshot.loadConcepts();
+    } else {
+        mlem2.setWeights(m_data->getWeights());
+        mlem2.setInputCases(m_data->getInputCases());
+        mlem2.generateAVBlocks(m_data);
+        concepts = mlem2.generateConcepts(m_data);
+        if(keepsSnapshot()){
+            string snapshotFile = m_sourceFile + ".snap";
+            if(DatasetSnapshot::write(snapshotFile, m_sourceSize, m_sourceChecksum, m_hashed ? m_datasetHash : 0,
+                                      m_options, m_data, m_numAttributes, mlem2.getAVBlocks(), concepts)){
+                cout << "Wrote snapshot " << snapshotFile << endl;
+            } else {
+                cerr << "Unable to write snapshot: " << snapshotFile << endl;
+            }
+        }
+    }
+
+    // IF: Checkpointing, resume from the last checkpoint of this dataset and these options
+    uint64_t inputHash = 0, inputSize = 0;
+    bool checkpointed = m_options.checkpoint && hashFile(m_sourceFile, inputHash, inputSize);
+    Checkpoint checkpoint(filename + ".ckpt", ResultCache::makeKey(inputHash, m_options),
+                          m_options.checkpointSeconds);
+    if(checkpointed && !checkpoint.load(mlem2.getAVBlocks().size())){
+        m_lastError = "refused to resume: " + checkpoint.getError();
+        cerr << "Refusing to resume from " << checkpoint.getError()
+             << "; remove it to start over" << endl;
+        for(Concept * concept : concepts){
+            delete concept;
+        }
+        file.close();
+        return false;
+    }
+    if(checkpointed){
+        if(checkpoint.getNumFinished() > 0 || checkpoint.getNumProgressRules() > 0){
+            cout << "Resuming after " << checkpoint.getNumFinished() << " finished concepts and "
+                 << checkpoint.getNumProgressRules() << " rules of the next" << endl;
+        }
+        checkpoint.setInputCases(m_snapshotBlocks ? m_snapshot.getInputCases() : m_data->getInputCases());
+        mlem2.setCheckpoint(&checkpoint);
+    } else if(m_options.checkpoint){
+        cerr << "Unable to read " << m_sourceFile << " to checkpoint it" << endl;
+    }
+
+    mlem2.generateRules(file, concepts);
+    // IF: Deadline cut induction short, mark the ruleset as partial quality
+    if(mlem2.isPartial()){
+        m_partial = true;
+        file << "! Partial-quality ruleset: deadline of " << m_options.deadlineSeconds
+             << " s reached; rules are valid but not minimal\n";
+        mlem2.reportDeadline(cout);
+    }
+    // ELSE IF: Rules were resumed from a run whose deadline was reached
+    else if(checkpointed && checkpoint.isPartial()){
+        m_partial = true;
+        file << "! Partial-quality ruleset: resumed from a checkpoint whose deadline was reached;"
+             << " rules are valid but not minimal\n";
+        cout << "Resumed checkpoint had reached its deadline: partial-quality ruleset" << endl;
+    }
+    if(m_options.sampleFraction > 0 && m_options.sampleFraction < 1){
+        mlem2.reportSampling(cout);
+    }
+    if(speculate){
+        mlem2.reportSpeculation(cout);
+    }
+
+    // IF: Blocks were stored, report the I/O they cost
+    if(stored){
+        store.report(cout);
+        if(m_stats){
+            m_stats->count(COUNT_STORE_BYTES_WRITTEN, store.getBytesWritten());
+            m_stats->count(COUNT_STORE_BYTES_READ, store.getBytesRead());
+            m_stats->count(COUNT_STORE_MAJOR_FAULTS, store.getMajorFaults());
+        }
+    }
+
+    // IF: Binary ruleset requested, write it next to the text output
+    if(m_options.binaryRules && !binary.write(filename + ".bin")){
+        m_lastError = "unable to write binary ruleset " + filename + ".bin";
+        cerr << "Unable to write binary ruleset: " << filename << ".bin" << endl;
+    }
 
     file.close();
+    // IF: Output is complete, the checkpoint is no longer needed
+    if(checkpointed && file){
+        checkpoint.complete();
+        cout << "Checkpoint saved " << checkpoint.getNumSaves() << " times; removed" << endl;
+    }
+    storeResult(filename);
     return true;
 }
 
+void Executive::generateSharded(ostream & file, string filename){
+    Algorithm mlem2(m_numAttributes, m_stats);
+    mlem2.setCutpointMode(m_options.cutpointMode, m_options.maxCutpoints);
+    mlem2.setSelection(m_options.selection);
+    if(m_options.speculativeSeeds > 1){
+        mlem2.setSpeculation(m_options.speculativeSeeds, m_options.numThreads);
+    }
+    if(m_options.sampleFraction > 0 || m_options.binaryRules || m_options.checkpoint
+       || !m_options.blockStoreDir.empty()){
+        cerr << "Ignoring --sample, --binary-rules, --checkpoint and --block-store with --workers" << endl;
+    }
+    ShardCoordinator shards(filename + ".shards", m_options.numWorkers, m_options);
+    if(m_options.deadlineSeconds > 0){
+        chrono::steady_clock::time_point deadline = m_start + chrono::duration_cast<chrono::steady_clock::duration>(
+                                                        chrono::duration<double>(m_options.deadlineSeconds));
+        mlem2.setDeadline(deadline);
+        shards.setDeadline(deadline);
+    }
+    // IF: No work directory, induce every concept here instead
+    bool sharded = shards.create();
+    if(!sharded){
+        cerr << "Unable to create work directory " << shards.getWorkDir()
+             << ".XXXXXX; inducing without workers" << endl;
+    }
+
+    // Workers read blocks and concepts from a snapshot; reuse the input's if it is current
+    vector<Concept *> concepts;
+    string snapshotFile = m_sourceFile + ".snap";
+    if(m_snapshotBlocks){
+        mlem2.setWeights(m_snapshot.getWeights());
+        mlem2.setInputCases(m_snapshot.getInputCases());
+        mlem2.setAVBlocks(m_snapshot.loadAVBlocks());
+        concepts = m_snapshot.loadConcepts();
+    } else {
+        mlem2.setWeights(m_data->getWeights());
+        mlem2.setInputCases(m_data->getInputCases());
+        mlem2.generateAVBlocks(m_data);
+        concepts = mlem2.generateConcepts(m_data);
+        // IF: Not keeping snapshots, the workers' copy lives in the work directory
+        if(!keepsSnapshot()){
+            snapshotFile = shards.getWorkDir() + "/dataset.snap";
+        }
+        // IF: Snapshot is kept or handed to workers, write it
+        if((sharded || keepsSnapshot())
+           && !DatasetSnapshot::write(snapshotFile, m_sourceSize, m_sourceChecksum, m_hashed ? m_datasetHash : 0,
+                                      m_options, m_data, m_numAttributes, mlem2.getAVBlocks(), concepts)){
+            cerr << "Unable to write snapshot: " << snapshotFile << endl;
+        } else if(keepsSnapshot()){
+            cout << "Wrote snapshot " << snapshotFile << endl;
+        }
+    }
+    if(sharded){
+        shards.start(snapshotFile, concepts);
+        shards.wait();
+    }
+
+    // FOR: Each concept in order, take the worker's rules or induce them here
+    size_t local = 0;
+    for(unsigned c = 0; c < concepts.size(); c++){
+        if(sharded && shards.appendOutput(c, file)){
+            delete concepts[c];
+        } else {
+            mlem2.generateRules(file, vector<Concept *>{concepts[c]});
+            local++;
+        }
+    }
+    // IF: A worker or the local induction ran out of time, the ruleset is partial quality
+    if(shards.isPartial() || mlem2.isPartial()){
+        m_partial = true;
+        file << "! Partial-quality ruleset: deadline of " << m_options.deadlineSeconds
+             << " s reached; rules are valid but not minimal\n";
+    }
+    if(!sharded){
+        return;
+    }
+    shards.report(cout);
+    if(local > 0){
+        m_lastError = to_string(local) + " concepts were not completed by a worker";
+        cerr << "Induced " << local << " concepts without a worker" << endl;
+    }
+}
+
+void Executive::generateIncremental(ostream & file){
+    IncrementalRuleset ruleset(m_data, m_numAttributes, m_options, m_start, m_stats);
+
+    // IF: Cases to append, add them and repair the rules
+    if(!m_options.appendFile.empty()){
+        vector<vector<string>> rows;
+        if(readCases(m_options.appendFile, rows)){
+            ruleset.appendCases(rows);
+            ruleset.report(cout);
+        } else {
+            m_lastError = "unable to read append file " + m_options.appendFile;
+            cerr << "Unable to read append file: " << m_options.appendFile << endl;
+        }
+    }
+
+    string error;
+    if(m_options.verify && !ruleset.verify(error)){
+        m_lastError = "verification failed: " + error;
+        cerr << "Verification failed: " << error << endl;
+    }
+
+    ScopedTimer timer(m_stats, PHASE_OUTPUT);
+    ruleset.write(file);
+    // IF: Deadline cut induction short, mark the ruleset as partial quality
+    if(ruleset.isPartial()){
+        m_partial = true;
+        file << "! Partial-quality ruleset: deadline of " << m_options.deadlineSeconds
+             << " s reached; rules are valid but not minimal\n";
+        ruleset.reportDeadline(cout);
+    }
+}
+
+void Executive::compareCutpoints(ostream & file){
+    Stats all, chosen;
+    size_t allBlocks = 0, chosenBlocks = 0;
+
+    // Baseline with all cutpoints; its rules are discarded
+    {
+        ostringstream discard;
+        Algorithm baseline(m_numAttributes, &all);
+        baseline.setWeights(m_data->getWeights());
+        baseline.setInputCases(m_data->getInputCases());
+        baseline.setSelection(m_options.selection);
+        baseline.generateRuleset(discard, m_data);
+        allBlocks = baseline.getAVBlocks().size();
+        for(AV * av : baseline.getAVBlocks()){
+            delete av;
+        }
+    }
+
+    Algorithm mlem2(m_numAttributes, &chosen);
+    mlem2.setCutpointMode(m_options.cutpointMode, m_options.maxCutpoints);
+    mlem2.setWeights(m_data->getWeights());
+    mlem2.setInputCases(m_data->getInputCases());
+    mlem2.setSelection(m_options.selection);
+    mlem2.generateRuleset(file, m_data);
+    chosenBlocks = mlem2.getAVBlocks().size();
+    if(m_stats){
+        m_stats->merge(chosen, "");
+    }
+
+    uint64_t allRules = all.getCount(COUNT_RULES_INDUCED) - all.getCount(COUNT_RULES_DROPPED);
+    uint64_t chosenRules = chosen.getCount(COUNT_RULES_INDUCED) - chosen.getCount(COUNT_RULES_DROPPED);
+    cout << "cutpoints\tblocks\trules\tinduction_seconds" << endl
+         << "all\t" << allBlocks << "\t" << allRules << "\t" << all.getTime(PHASE_INDUCTION) << endl
+         << cutpointModeName(m_options.cutpointMode) << "\t" << chosenBlocks
+         << "\t" << chosenRules << "\t" << chosen.getTime(PHASE_INDUCTION) << endl
+         << "Eliminated " << allBlocks - chosenBlocks << " blocks" << endl;
+}
+
+void Executive::compareSpeculation(ostream & file){
+    Stats sequential, speculative;
+
+    // Baseline one rule at a time; its rules are discarded
+    {
+        ostringstream discard;
+        Algorithm baseline(m_numAttributes, &sequential);
+        baseline.setCutpointMode(m_options.cutpointMode, m_options.maxCutpoints);
+        baseline.setWeights(m_data->getWeights());
+        baseline.setInputCases(m_data->getInputCases());
+        baseline.setSelection(m_options.selection);
+        baseline.generateRuleset(discard, m_data);
+        for(AV * av : baseline.getAVBlocks()){
+            delete av;
+        }
+    }
+
+    Algorithm mlem2(m_numAttributes, &speculative);
+    mlem2.setCutpointMode(m_options.cutpointMode, m_options.maxCutpoints);
+    mlem2.setWeights(m_data->getWeights());
+    mlem2.setInputCases(m_data->getInputCases());
+    mlem2.setSelection(m_options.selection);
+    mlem2.setSpeculation(m_options.speculativeSeeds, m_options.numThreads);
+    mlem2.generateRuleset(file, m_data);
+    mlem2.reportSpeculation(cout);
+    if(m_stats){
+        m_stats->merge(speculative, "");
+    }
+
+    cout << "induction\trules\tconditions_per_rule\tstrength_per_rule\tinduction_seconds" << endl;
+    for(const Stats * stats : {&sequential, &speculative}){
+        uint64_t rules = stats->getCount(COUNT_RULES_INDUCED) - stats->getCount(COUNT_RULES_DROPPED);
+        double perRule = rules ? 1.0 / rules : 0;
+        cout << (stats == &sequential ? "sequential" : "speculative") << "\t" << rules << "\t"
+             << stats->getCount(COUNT_RULE_CONDITIONS) * perRule << "\t"
+             << stats->getCount(COUNT_RULE_STRENGTH) * perRule << "\t"
+             << stats->getTime(PHASE_INDUCTION) << endl;
+    }
+    double seconds = speculative.getTime(PHASE_INDUCTION);
+    cout << "Speedup " << (seconds > 0 ? sequential.getTime(PHASE_INDUCTION) / seconds : 0)
+         << "x with " << m_options.speculativeSeeds << " seeds" << endl;
+}
+
+bool Executive::cachesResult() const {
+    // Comparisons print to the console and binary rulesets are a second output
+    return m_resultCache && m_hashed && inducesOnce() && !m_options.compareCutpoints
+           && !(m_options.compareSpeculation && m_options.speculativeSeeds > 1)
+           && !m_options.binaryRules;
+}
+
+void Executive::storeResult(string filename){
+    if(!cachesResult() || !m_lastError.empty() || m_partial){
+        return;
+    }
+    if(!m_resultCache->store(ResultCache::makeKey(m_datasetHash, m_options), filename)){
+        cerr << "Unable to keep " << filename << " in the result cache" << endl;
+    }
+}
+
+bool Executive::keepsSnapshot() const {
+    return m_options.snapshot && m_sourceFile != "-";
+}
+
+bool Executive::inducesOnce() const {
+    return m_options.cvFolds == 0 && m_options.appendFile.empty() && !m_options.verify;
+}
+
+bool Executive::loadSnapshot(string filename){
+    m_sourceFile = filename;
+    // IF: Input cannot be read, let parsing report it
+    if(!hashFile(filename, m_sourceChecksum, m_sourceSize)){
+        return false;
+    }
+
+    ScopedTimer timer(m_stats, PHASE_PARSE);
+    MemScope memScope(MEM_DATASET);
+    TraceSpan span("loadSnapshot", filename);
+    string snapshotFile = filename + ".snap";
+    if(!m_snapshot.open(snapshotFile) || !m_snapshot.matchesSource(m_sourceSize, m_sourceChecksum)){
+        return false;
+    }
+    // Result cache keys come from the tokens, which the snapshot hashed when it was written
+    m_datasetHash = m_snapshot.getDatasetHash();
+    m_hashed = m_datasetHash != 0;
+
+    // IF: Blocks and concepts can be used as they are, only the names are needed
+    // (comparisons induce twice from the cases, so they need the whole dataset)
+    if(inducesOnce() && !m_options.compareCutpoints
+       && !(m_options.compareSpeculation && m_options.speculativeSeeds > 1)
+       && m_snapshot.matchesOptions(m_options)){
+        m_numAttributes = m_snapshot.getNumAttributes();
+        m_data = m_snapshot.loadSchema();
+        m_snapshotBlocks = true;
+        cout << "Loaded snapshot " << snapshotFile << endl;
+        return true;
+    }
+    // ELSE IF: Cells are of every case in input order, rebuild the dataset from them
+    if(!m_snapshot.isCollapsed() && !m_snapshot.isRenumbered()){
+        m_numAttributes = m_snapshot.getNumAttributes();
+        m_data = m_snapshot.loadDataset();
+        prepareCases(filename);
+        cout << "Loaded cases from snapshot " << snapshotFile << endl;
+        return true;
+    }
+    return false;
+}
+
+string Executive::getLastError() const {
+    return m_lastError;
+}
+
+size_t Executive::getNumAttributes() const {
+    return m_numAttributes;
+}
+
+Dataset * Executive::releaseDataset(){
+    Dataset * data = m_data;
+    m_data = nullptr;
+    return data;
+}
+
+void Executive::setOptions(const Options & options){
+    m_options = options;
+}
+
+void Executive::setStats(Stats * stats){
+    m_stats = stats;
+}
+
+void Executive::setResultCache(ResultCache * cache){
+    m_resultCache = cache;
+}
+
 void Executive::parseFormat(istream& file){
     if(file.eof()){
         cerr << "No format found." << endl;
@@ -117,9 +641,57 @@ void Executive::parseHeader(istream& file){
     for(unsigned i = 0; i < m_numAttributes; i++){
         buffer >> word;
         m_data->addAttribute(word);      
+        m_datasetHash = hashString(word, m_datasetHash);
     }
     buffer >> word;
     m_data->setDecision(word);
+    m_datasetHash = hashString(word, m_datasetHash);
+}
+
+bool Executive::readCases(string filename, vector<vector<string>> & rows){
+    InputStream file;
+    file.open(filename);
+
+    // Unable to open file; Signal with boolean
+    if(!file) {
+        return false;
+    }
+
+    string word;
+    while(nextValue(file, word)){
+        // IF: Previous case is complete, start a new one
+        if(rows.empty() || rows.back().size() == m_numAttributes + 1){
+            rows.push_back(vector<string>());
+        }
+        rows.back().push_back(word);
+    }
+    // IF: Last case is incomplete, ignore it
+    if(!rows.empty() && rows.back().size() != m_numAttributes + 1){
+        cerr << "Ignoring incomplete case at end of " << filename << endl;
+        rows.pop_back();
+    }
+    // IF: Input ended early, its cases are incomplete
+    if(!file.getError().empty()){
+        cerr << "Unable to read " << filename << ": " << file.getError() << endl;
+        return false;
+    }
+    return true;
+}
+
+bool Executive::nextValue(istream & file, string & word){
+    while(file >> word){
+        size_t pos = word.find('!');
+        // IF: Word starts a comment, drop the rest of the line
+        if(pos != string::npos){
+            word.erase(pos);
+            string comment;
+            getline(file, comment, '\n');
+        }
+        if(!word.empty()){
+            return true;
+        }
+    }
+    return false;
 }
 
 string Executive::removeComments(istream & file){
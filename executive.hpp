@@ -11,7 +11,13 @@
 #ifndef EXECUTIVE_H
 #define EXECUTIVE_H
 #include "dataset.hpp"
+#include "datasetSnapshot.hpp"
+#include "options.hpp"
+#include "resultCache.hpp"
+#include "stats.hpp"
+#include <chrono>
 #include <string>
+#include <vector>
 
 class Executive {
 public:
@@ -22,13 +28,102 @@ public:
        @returns True if file read is successful; false, otherwise. */
     bool parseInFile(std::string filename);
 
-    /* Prints ruleset structure to a file.
-       @returns True if file write is successful; false, otherwise. */
+    /* Prints ruleset structure to a file; with cross-validation
+       enabled, prints the cross-validation report instead.
+       @returns True if file write is successful; false, otherwise (also when
+                a checkpoint is refused, with the reason in getLastError). */
     bool generateOutFile(std::string filename);
 
+    /* Sets the options for the following runs. */
+    void setOptions(const Options & options);
+
+    /* Reads cases (attribute values then decision, no header) to append
+       to the parsed dataset; "!" comments are allowed.
+       @returns True if file read is successful; false, otherwise. */
+    bool readCases(std::string filename, std::vector<std::vector<std::string>> & rows);
+
+    /* Describes why the last generated output is not trusted (e.g. failed
+       verification); empty if it is. */
+    std::string getLastError() const;
+
+    /* Gets number of attributes of the parsed file. */
+    std::size_t getNumAttributes() const;
+
+    /* Hands the parsed dataset over to the caller, who must delete it. */
+    Dataset * releaseDataset();
+
+    /* Enables recording of run statistics; nullptr disables. */
+    void setStats(Stats * stats);
+
+    /* Reuses rulesets of parsed datasets induced before with the same
+       options, and keeps new ones; nullptr (the default) disables. */
+    void setResultCache(ResultCache * cache);
+
 private:
     Dataset * m_data;
     std::size_t m_numAttributes;
+    Stats * m_stats;
+    Options m_options;
+    std::string m_lastError;
+
+    /* Snapshot of the input; its blocks and concepts are used when valid. */
+    DatasetSnapshot m_snapshot;
+    bool m_snapshotBlocks;
+    std::uint64_t m_sourceSize;
+    std::uint64_t m_sourceChecksum;
+    std::string m_sourceFile;
+
+    /* Hash of the parsed tokens (format, header and values), computed
+       while parsing or taken from a snapshot; m_hashed is false if unknown. */
+    std::uint64_t m_datasetHash;
+    bool m_hashed;
+    ResultCache * m_resultCache;
+
+    /* When the job started, for the deadline; set by parseInFile. */
+    std::chrono::steady_clock::time_point m_start;
+
+    /* Whether the last output was cut short by the deadline. */
+    bool m_partial;
+
+    /* Checks if snapshots are requested and the input is a file, not standard input. */
+    bool keepsSnapshot() const;
+
+    /* Checks if the run induces one ruleset from the whole loaded dataset
+       (no cross-validation, appending or verifying). */
+    bool inducesOnce() const;
+
+    /* parseFile HELPER: Loads the input's snapshot if it is of the same contents.
+       @returns True if m_data was loaded from it; false, otherwise. */
+    bool loadSnapshot(std::string filename);
+
+    /* parseFile HELPER: Collapses duplicate cases and renumbers cases, as
+       the options ask, when one ruleset is induced from the dataset. */
+    void prepareCases(std::string filename);
+
+    /* Checks if the output can be taken from or kept in the result cache. */
+    bool cachesResult() const;
+
+    /* generateOutFile HELPER: Keeps a completed output in the result cache. */
+    void storeResult(std::string filename);
+
+    /* generateOutFile HELPER: Induces rules with all cutpoints and with the
+       chosen mode, writes the latter and prints blocks, rules and induction
+       time of both. */
+    void compareCutpoints(std::ostream & file);
+
+    /* generateOutFile HELPER: Induces rules one at a time and speculatively,
+       writes the latter and prints rules, conditions and strength per rule,
+       and induction time of both. */
+    void compareSpeculation(std::ostream & file);
+
+    /* generateOutFile HELPER: Builds blocks and concepts once, hands them to
+       worker processes through a snapshot and merges their rules in concept
+       order; concepts a worker did not complete are induced here. */
+    void generateSharded(std::ostream & file, std::string filename);
+
+    /* generateOutFile HELPER: Induces rules, appends cases and repairs the
+       rules, then verifies them if requested. */
+    void generateIncremental(std::ostream & file);
 
     /* parseFile HELPER: Parses format line. */
     void parseFormat(std::istream& file);
@@ -36,6 +131,10 @@ private:
     /* parseFile HELPER: Parses header line. */
     void parseHeader(std::istream& file);
 
+    /* parseFile HELPER: Reads the next value, skipping comments.
+       @returns False at end of file. */
+    bool nextValue(std::istream & file, std::string & word);
+
     /* parseFile HELPER: Removes comments. */
     std::string removeComments(std::istream & file);
 };
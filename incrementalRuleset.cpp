@@ -0,0 +1,259 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the incremental ruleset class.
+    @file incrementalRuleset.cpp
+
+    This class keeps a dataset, its attribute-value
+    blocks and one local covering per concept, and
+    maintains them as new cases are appended. */
+
+#include "incrementalRuleset.hpp"
+
+using namespace std;
+
+IncrementalRuleset::IncrementalRuleset(Dataset * data, size_t numAttributes, const Options & options,
+                                       chrono::steady_clock::time_point start, Stats * stats)
+    : m_data(data), m_numAttributes(numAttributes), m_cutpointMode(options.cutpointMode),
+      m_maxCutpoints(options.maxCutpoints), m_mlem2(numAttributes, stats),
+      m_casesAdded(0), m_blocksAdded(0), m_blocksRetired(0),
+      m_rulesRemoved(0), m_rulesAdded(0), m_conceptsTouched(0) {
+    m_mlem2.setCutpointMode(options.cutpointMode, options.maxCutpoints);
+    m_mlem2.setSelection(options.selection);
+    m_mlem2.setSampling(options.sampleFraction);
+    if(options.speculativeSeeds > 1){
+        m_mlem2.setSpeculation(options.speculativeSeeds, options.numThreads);
+    }
+    if(options.deadlineSeconds > 0){
+        m_mlem2.setDeadline(start + chrono::duration_cast<chrono::steady_clock::duration>(
+                                chrono::duration<double>(options.deadlineSeconds)));
+    }
+    m_mlem2.setWeights(data->getWeights());
+    m_mlem2.setInputCases(data->getInputCases());
+    m_mlem2.generateAVBlocks(data);
+    m_avBlocks = m_mlem2.getAVBlocks();
+
+    // Index blocks; numeric blocks come in (min..c, c..max) pairs per cutpoint
+    for(unsigned i = 0; i < m_avBlocks.size(); i++){
+        int col = m_avBlocks[i]->getAttrCol();
+        if(m_avBlocks[i]->isNumeric()){
+            AVNumeric * low = (AVNumeric *) m_avBlocks[i];
+            m_cutBlocks[col][low->getUpperBound()] = make_pair(i, i + 1);
+            i++;
+        } else {
+            m_valueBlocks[col][((AVSymbolic *) m_avBlocks[i])->getValue()] = i;
+        }
+    }
+
+    m_concepts = m_mlem2.generateConcepts(data);
+    for(unsigned c = 0; c < m_concepts.size(); c++){
+        m_conceptIndex[m_concepts[c]->getValue()] = c;
+        m_covers.push_back(m_mlem2.induceRules(m_concepts[c]));
+    }
+}
+
+IncrementalRuleset::~IncrementalRuleset(){
+    for(LocalCover & lc : m_covers){
+        for(Rule * rule : lc.getRules()){
+            delete rule;
+        }
+    }
+    for(Concept * concept : m_concepts){
+        delete concept;
+    }
+    for(AV * av : m_avBlocks){
+        delete av;
+    }
+}
+
+void IncrementalRuleset::appendCases(const vector<vector<string>> & rows){
+    m_casesAdded = rows.size();
+    m_blocksAdded = m_blocksRetired = m_rulesRemoved = m_rulesAdded = m_conceptsTouched = 0;
+    if(rows.empty()){
+        return;
+    }
+
+    int firstNew = m_data->getNumCases() + 1;
+    for(const vector<string> & row : rows){
+        for(unsigned col = 0; col <= m_numAttributes; col++){
+            m_data->addValue(col, row[col]);
+        }
+    }
+
+    // FOR: Each attribute, update its blocks with the new cases
+    for(unsigned col = 0; col < m_numAttributes; col++){
+        if(m_data->getValue(1, col)->isNumeric()){
+            updateNumeric(col, firstNew);
+        } else {
+            updateSymbolic(col, firstNew);
+        }
+    }
+    m_mlem2.setAVBlocks(m_avBlocks);
+
+    // FOR: Each new case, add it to its concept (new decision values get new concepts)
+    for(unsigned r = firstNew; r <= m_data->getNumCases(); r++){
+        string value = m_data->getValue(r, m_numAttributes)->getStrValue();
+        if(!m_conceptIndex.count(value)){
+            m_conceptIndex[value] = m_concepts.size();
+            m_concepts.push_back(new Concept(m_data->getDecision(), value));
+            m_covers.push_back(LocalCover(m_concepts.back()));
+        }
+        m_concepts[m_conceptIndex[value]]->addCase(r);
+    }
+
+    for(LocalCover & lc : m_covers){
+        repairCover(lc);
+    }
+}
+
+bool IncrementalRuleset::verify(string & error) const {
+    // FOR: Each covering, check its rules and their union
+    for(const LocalCover & lc : m_covers){
+        set<int> B = lc.getConcept()->getBlock();
+        for(Rule * rule : lc.getRules()){
+            if(rule->empty()){
+                error = "empty rule for " + lc.getConcept()->labelString();
+                return false;
+            }
+            if(!subsetEq(rule->getBlock(m_avBlocks), B)){
+                error = "inconsistent rule " + rule->toString(m_avBlocks)
+                        + " for " + lc.getConcept()->labelString();
+                return false;
+            }
+        }
+        if(lc.getCoveredConditions(m_avBlocks) != B){
+            error = "rules do not cover " + lc.getConcept()->labelString();
+            return false;
+        }
+    }
+    return true;
+}
+
+void IncrementalRuleset::write(ostream & file) const {
+    vector<string> labels(m_avBlocks.size());
+    for(const LocalCover & lc : m_covers){
+        lc.write(file, m_avBlocks, labels, m_data->getWeights());
+    }
+}
+
+void IncrementalRuleset::report(ostream & stream) const {
+    stream << "Appended " << m_casesAdded << " cases: "
+           << m_blocksAdded << " blocks added, " << m_blocksRetired << " retired; "
+           << m_rulesRemoved << " rules removed, " << m_rulesAdded << " added in "
+           << m_conceptsTouched << " concepts" << endl;
+}
+
+bool IncrementalRuleset::isPartial() const {
+    return m_mlem2.isPartial();
+}
+
+void IncrementalRuleset::reportDeadline(ostream & stream) const {
+    m_mlem2.reportDeadline(stream);
+}
+
+void IncrementalRuleset::updateNumeric(int col, int firstNew){
+    float min = 0, max = 0;
+    // Cutpoints are chosen as the initial blocks were, over all cases
+    list<float> cutpoints;
+    if(m_cutpointMode == CUT_BOUNDARY){
+        cutpoints = m_data->discretizeBoundaries(col, min, max);
+    } else if(m_cutpointMode == CUT_QUANTILE){
+        cutpoints = m_data->discretizeQuantiles(col, min, max, m_maxCutpoints);
+    } else {
+        cutpoints = m_data->discretize(col, min, max);
+    }
+    set<float> current(cutpoints.begin(), cutpoints.end());
+    map<float, pair<int, int>> & blocks = m_cutBlocks[col];
+
+    // FOR: Each known cutpoint, retire it if it disappeared; otherwise widen and extend its blocks
+    for(auto iter = blocks.begin(); iter != blocks.end();){
+        AVNumeric * low = (AVNumeric *) m_avBlocks[iter->second.first];
+        AVNumeric * high = (AVNumeric *) m_avBlocks[iter->second.second];
+        if(!current.count(iter->first)){
+            // Emptying keeps indices stable; rules using the block become empty and are removed
+            low->setBlock(set<int>());
+            high->setBlock(set<int>());
+            m_blocksRetired += 2;
+            iter = blocks.erase(iter);
+            continue;
+        }
+        low->setBounds(min, iter->first);
+        high->setBounds(iter->first, max);
+        for(unsigned r = firstNew; r <= m_data->getNumCases(); r++){
+            low->addOnMatch(m_data->getValue(r, col), r);
+            high->addOnMatch(m_data->getValue(r, col), r);
+        }
+        iter++;
+    }
+
+    // FOR: Each new cutpoint, add its pair of blocks
+    string attr = m_data->getAttribute(col);
+    for(float c : cutpoints){
+        if(!blocks.count(c)){
+            int low = addBlock(new AVNumeric(attr, col, min, c));
+            int high = addBlock(new AVNumeric(attr, col, c, max));
+            blocks[c] = make_pair(low, high);
+        }
+    }
+}
+
+void IncrementalRuleset::updateSymbolic(int col, int firstNew){
+    map<string, int> & blocks = m_valueBlocks[col];
+    string attr = m_data->getAttribute(col);
+
+    // FOR: Each new case, add it to the block of its value (new values get new blocks)
+    for(unsigned r = firstNew; r <= m_data->getNumCases(); r++){
+        string value = m_data->getValue(r, col)->getStrValue();
+        if(blocks.count(value)){
+            m_avBlocks[blocks[value]]->addOnMatch(m_data->getValue(r, col), r);
+        } else {
+            blocks[value] = addBlock(new AVSymbolic(attr, col, value));
+        }
+    }
+}
+
+int IncrementalRuleset::addBlock(AV * av){
+    for(unsigned r = 1; r <= m_data->getNumCases(); r++){
+        av->addOnMatch(m_data->getValue(r, av->getAttrCol()), r);
+    }
+    m_avBlocks.push_back(av);
+    m_blocksAdded++;
+    return m_avBlocks.size() - 1;
+}
+
+void IncrementalRuleset::repairCover(LocalCover & lc){
+    set<int> B = lc.getConcept()->getBlock();
+
+    // FOR: Each rule, remove it if it now matches cases outside the concept
+    for(Rule * rule : lc.getRules()){
+        set<int> block = rule->getBlock(m_avBlocks);
+        if(block.empty() || !subsetEq(block, B)){
+            lc.removeRule(rule);
+            delete rule;
+            m_rulesRemoved++;
+        }
+    }
+
+    // IF: Concept is still covered, nothing to re-induce
+    if(lc.getCoveredConditions(m_avBlocks) == B){
+        return;
+    }
+    m_conceptsTouched++;
+
+    set<int> kept;
+    for(Rule * rule : lc.getRules()){
+        kept.insert(rule->id);
+    }
+    m_mlem2.extendCover(lc);
+
+    // Only the new rules may be dropped; kept rules stay as they are
+    set<int> added;
+    for(Rule * rule : lc.getRules()){
+        if(!kept.count(rule->id)){
+            added.insert(rule->id);
+        }
+    }
+    lc.dropRules(m_avBlocks, B, &added);
+    m_rulesAdded += lc.size() - kept.size();
+}
@@ -0,0 +1,102 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the incremental ruleset class.
+    @file incrementalRuleset.hpp
+
+    This class keeps a dataset, its attribute-value
+    blocks and one local covering per concept, and
+    maintains them as new cases are appended: only
+    rules that became invalid are removed, and only
+    cases left uncovered are re-induced.
+
+    Block indices must stay stable for the rules that
+    are kept, so new blocks and concepts are added at
+    the end and blocks whose cutpoint disappears are
+    emptied rather than removed. Tie-breaking may
+    therefore differ from a full rerun on the data. */
+
+#ifndef INCREMENTAL_RULESET_H
+#define INCREMENTAL_RULESET_H
+#include "algorithm.hpp"
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class IncrementalRuleset {
+public:
+    /* Builds blocks and concepts and induces the initial rules.
+       @param data, not owned; appended cases are added to it.
+       @param options, cutpoints, selection, sampling, speculation and deadline to induce with.
+       @param start, when the job started; the deadline counts from it. */
+    IncrementalRuleset(Dataset * data, std::size_t numAttributes, const Options & options,
+                       std::chrono::steady_clock::time_point start, Stats * stats = nullptr);
+    ~IncrementalRuleset();
+
+    /* Appends cases (attribute values then decision) and repairs the rules. */
+    void appendCases(const std::vector<std::vector<std::string>> & rows);
+
+    /* Checks that every covering is a valid local covering of its concept:
+       each rule is non-empty and consistent, and the rules cover the concept.
+       @param error, describes the first problem found.
+       @returns True if all coverings are valid. */
+    bool verify(std::string & error) const;
+
+    /* Prints all rules, concept by concept. */
+    void write(std::ostream & file) const;
+
+    /* Prints what the last append changed. */
+    void report(std::ostream & stream) const;
+
+    /* @returns True if the deadline cut induction short. */
+    bool isPartial() const;
+
+    /* Prints what the deadline cut short. */
+    void reportDeadline(std::ostream & stream) const;
+
+private:
+    Dataset * m_data;
+    std::size_t m_numAttributes;
+    CutpointMode m_cutpointMode;
+    std::size_t m_maxCutpoints;
+    Algorithm m_mlem2;
+    std::vector<AV *> m_avBlocks;
+    std::vector<Concept *> m_concepts;
+    std::vector<LocalCover> m_covers;
+
+    /* Per numeric column: cutpoint -> indices of its (min..c, c..max) blocks. */
+    std::map<int, std::map<float, std::pair<int, int>>> m_cutBlocks;
+
+    /* Per symbolic column: value -> index of its block. */
+    std::map<int, std::map<std::string, int>> m_valueBlocks;
+
+    /* Decision value -> index of its concept. */
+    std::map<std::string, int> m_conceptIndex;
+
+    /* Counts from the last append. */
+    std::size_t m_casesAdded;
+    std::size_t m_blocksAdded;
+    std::size_t m_blocksRetired;
+    std::size_t m_rulesRemoved;
+    std::size_t m_rulesAdded;
+    std::size_t m_conceptsTouched;
+
+    /* Updates the blocks of a numeric column for cases firstNew and up. */
+    void updateNumeric(int col, int firstNew);
+
+    /* Updates the blocks of a symbolic column for cases firstNew and up. */
+    void updateSymbolic(int col, int firstNew);
+
+    /* Adds a new block and fills it from all cases.
+       @returns Index of the block. */
+    int addBlock(AV * av);
+
+    /* Removes rules that became inconsistent or empty and induces
+       rules for cases of the concept that are no longer covered. */
+    void repairCover(LocalCover & lc);
+};
+#endif
@@ -0,0 +1,392 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the input stream class.
+    @file inputStream.cpp
+
+    This class reads plain, gzip or zstd input
+    as text, decompressing on a reader thread. */
+
+#include "inputStream.hpp"
+#include <cerrno>
+#include <cstring>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+using namespace std;
+
+/* Bytes of raw input read at a time. */
+#define INPUT_READ_SIZE (64 * 1024)
+
+/* The parts of the zstd streaming API used here, as declared in zstd.h;
+   the library is loaded on first use. */
+struct ZstdInBuffer {
+    const void * src;
+    size_t size;
+    size_t pos;
+};
+
+struct ZstdOutBuffer {
+    void * dst;
+    size_t size;
+    size_t pos;
+};
+
+struct ZstdApi {
+    void * (* createDStream)();
+    size_t (* freeDStream)(void *);
+    size_t (* initDStream)(void *);
+    size_t (* decompressStream)(void *, ZstdOutBuffer *, ZstdInBuffer *);
+    unsigned (* isError)(size_t);
+    const char * (* getErrorName)(size_t);
+};
+
+/* Loads libzstd once.
+   @returns nullptr if it or one of its functions is missing. */
+static const ZstdApi * loadZstd(){
+    static const ZstdApi * api = []() -> const ZstdApi * {
+        void * handle = dlopen("libzstd.so.1", RTLD_NOW | RTLD_LOCAL);
+        if(!handle){
+            return nullptr;
+        }
+        static ZstdApi loaded;
+        loaded.createDStream = (void * (*)()) dlsym(handle, "ZSTD_createDStream");
+        loaded.freeDStream = (size_t (*)(void *)) dlsym(handle, "ZSTD_freeDStream");
+        loaded.initDStream = (size_t (*)(void *)) dlsym(handle, "ZSTD_initDStream");
+        loaded.decompressStream = (size_t (*)(void *, ZstdOutBuffer *, ZstdInBuffer *))
+                                  dlsym(handle, "ZSTD_decompressStream");
+        loaded.isError = (unsigned (*)(size_t)) dlsym(handle, "ZSTD_isError");
+        loaded.getErrorName = (const char * (*)(size_t)) dlsym(handle, "ZSTD_getErrorName");
+        if(!loaded.createDStream || !loaded.freeDStream || !loaded.initDStream
+           || !loaded.decompressStream || !loaded.isError || !loaded.getErrorName){
+            return nullptr;
+        }
+        return &loaded;
+    }();
+    return api;
+}
+
+InputBuffer::InputBuffer()
+    : m_fd(-1), m_ownsFd(false), m_compression(COMPRESSION_NONE), m_done(false), m_stop(false) {
+    setg(nullptr, nullptr, nullptr);
+}
+
+InputBuffer::~InputBuffer(){
+    {
+        lock_guard<mutex> guard(m_lock);
+        m_stop = true;
+    }
+    m_drained.notify_all();
+    if(m_reader.joinable()){
+        m_reader.join();
+    }
+    if(m_ownsFd){
+        close(m_fd);
+    }
+}
+
+bool InputBuffer::open(string filename){
+    if(filename == "-"){
+        m_fd = STDIN_FILENO;
+    } else {
+        m_fd = ::open(filename.c_str(), O_RDONLY);
+        m_ownsFd = m_fd >= 0;
+    }
+    if(m_fd < 0){
+        return false;
+    }
+
+    // Read enough to recognize the format; a short input is plain text
+    m_head.resize(4);
+    size_t got = 0;
+    while(got < m_head.size()){
+        ssize_t n = ::read(m_fd, m_head.data() + got, m_head.size() - got);
+        if(n < 0 && errno == EINTR){
+            continue;
+        }
+        if(n <= 0){
+            break;
+        }
+        got += n;
+    }
+    m_head.resize(got);
+    const unsigned char * magic = (const unsigned char *) m_head.data();
+    if(got >= 2 && magic[0] == 0x1f && magic[1] == 0x8b){
+        m_compression = COMPRESSION_GZIP;
+    } else if(got >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd){
+        m_compression = COMPRESSION_ZSTD;
+    }
+
+    m_reader = thread(&InputBuffer::read, this);
+    return true;
+}
+
+Compression InputBuffer::getCompression() const {
+    return m_compression;
+}
+
+string InputBuffer::getError(){
+    lock_guard<mutex> guard(m_lock);
+    return m_error;
+}
+
+InputBuffer::int_type InputBuffer::underflow(){
+    unique_lock<mutex> guard(m_lock);
+    // WHILE: No chunk is ready and the reader is still going, wait
+    while(m_chunks.empty() && !m_done){
+        m_filled.wait(guard);
+    }
+    if(m_chunks.empty()){
+        return traits_type::eof();
+    }
+    m_current.swap(m_chunks.front());
+    m_chunks.pop_front();
+    guard.unlock();
+    m_drained.notify_one();
+
+    setg(m_current.data(), m_current.data(), m_current.data() + m_current.size());
+    return traits_type::to_int_type(m_current[0]);
+}
+
+void InputBuffer::read(){
+    bool complete = false;
+    switch(m_compression){
+        case COMPRESSION_GZIP: complete = inflateGzip(); break;
+        case COMPRESSION_ZSTD: complete = decompressZstd(); break;
+        default: complete = copyPlain(); break;
+    }
+    lock_guard<mutex> guard(m_lock);
+    if(!complete && m_error.empty() && !m_stop){
+        m_error = strerror(errno);
+    }
+    m_done = true;
+    m_filled.notify_all();
+}
+
+long InputBuffer::readRaw(char * buffer, size_t size){
+    if(!m_head.empty()){
+        size_t n = min(size, m_head.size());
+        memcpy(buffer, m_head.data(), n);
+        m_head.erase(m_head.begin(), m_head.begin() + n);
+        return n;
+    }
+    // WHILE: Interrupted before reading anything, try again
+    while(true){
+        ssize_t n = ::read(m_fd, buffer, size);
+        if(n < 0 && errno == EINTR){
+            continue;
+        }
+        return n;
+    }
+}
+
+bool InputBuffer::push(vector<char> & chunk){
+    unique_lock<mutex> guard(m_lock);
+    // WHILE: Parser is far enough behind, wait for it
+    while(m_chunks.size() >= INPUT_CHUNKS_AHEAD && !m_stop){
+        m_drained.wait(guard);
+    }
+    if(m_stop){
+        return false;
+    }
+    m_chunks.push_back(move(chunk));
+    chunk = vector<char>();
+    chunk.reserve(INPUT_CHUNK_SIZE);
+    m_filled.notify_one();
+    return true;
+}
+
+bool InputBuffer::copyPlain(){
+    vector<char> chunk(INPUT_CHUNK_SIZE);
+    // WHILE: Input has more bytes, read a chunk's worth and queue it
+    while(true){
+        size_t filled = 0;
+        long n = 0;
+        while(filled < chunk.size() && (n = readRaw(chunk.data() + filled, chunk.size() - filled)) > 0){
+            filled += n;
+        }
+        if(n < 0){
+            return false;
+        }
+        if(filled == 0){
+            return true;
+        }
+        chunk.resize(filled);
+        if(!push(chunk)){
+            return true;
+        }
+        chunk.resize(INPUT_CHUNK_SIZE);
+        if(n == 0){
+            return true;
+        }
+    }
+}
+
+bool InputBuffer::inflateGzip(){
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    // 15 + 32: largest window, gzip or zlib header detected automatically
+    if(inflateInit2(&z, 15 + 32) != Z_OK){
+        m_error = "unable to start gzip decompression";
+        return false;
+    }
+    vector<char> in(INPUT_READ_SIZE);
+    // Chunk holds only inflated bytes; it is grown to inflate into and cut back
+    vector<char> chunk;
+    chunk.reserve(INPUT_CHUNK_SIZE);
+    bool ok = true, ended = false;
+
+    // WHILE: Input has more bytes, inflate them into chunks
+    while(ok){
+        long n = readRaw(in.data(), in.size());
+        if(n < 0){
+            ok = false;
+            break;
+        }
+        if(n == 0){
+            break;
+        }
+        z.next_in = (Bytef *) in.data();
+        z.avail_in = n;
+        // WHILE: Read bytes are left, inflate into the current chunk
+        while(z.avail_in > 0){
+            // IF: Last member ended and more follows, start the next member
+            if(ended){
+                inflateReset(&z);
+                ended = false;
+            }
+            size_t used = chunk.size();
+            chunk.resize(INPUT_CHUNK_SIZE);
+            z.next_out = (Bytef *) chunk.data() + used;
+            z.avail_out = INPUT_CHUNK_SIZE - used;
+            int status = inflate(&z, Z_NO_FLUSH);
+            chunk.resize(INPUT_CHUNK_SIZE - z.avail_out);
+            if(status == Z_STREAM_END){
+                ended = true;
+            } else if(status != Z_OK && status != Z_BUF_ERROR){
+                m_error = string("damaged gzip input: ") + (z.msg ? z.msg : "inflate failed");
+                ok = false;
+                break;
+            }
+            if(chunk.size() == INPUT_CHUNK_SIZE && !push(chunk)){
+                inflateEnd(&z);
+                return true;
+            }
+        }
+        if(chunk.size() == INPUT_CHUNK_SIZE && !push(chunk)){
+            break;
+        }
+    }
+    // IF: Input ended inside a member, part of it is missing
+    if(ok && !ended){
+        m_error = "truncated gzip input";
+        ok = false;
+    }
+    inflateEnd(&z);
+    if(!chunk.empty()){
+        push(chunk);
+    }
+    return ok;
+}
+
+bool InputBuffer::decompressZstd(){
+    const ZstdApi * zstd = loadZstd();
+    if(!zstd){
+        m_error = "zstd input needs libzstd.so.1, which could not be loaded";
+        return false;
+    }
+    void * stream = zstd->createDStream();
+    if(!stream || zstd->isError(zstd->initDStream(stream))){
+        m_error = "unable to start zstd decompression";
+        if(stream){
+            zstd->freeDStream(stream);
+        }
+        return false;
+    }
+    vector<char> in(INPUT_READ_SIZE);
+    vector<char> chunk(INPUT_CHUNK_SIZE);
+    size_t used = 0;
+    size_t hint = 1;
+    bool ok = true;
+
+    // WHILE: Input has more bytes, decompress them into chunks
+    while(ok){
+        long n = readRaw(in.data(), in.size());
+        if(n < 0){
+            ok = false;
+            break;
+        }
+        if(n == 0){
+            break;
+        }
+        ZstdInBuffer input = {in.data(), (size_t) n, 0};
+        // WHILE: Read bytes are left, or output may still be pending
+        while(input.pos < input.size){
+            ZstdOutBuffer output = {chunk.data(), chunk.size(), used};
+            hint = zstd->decompressStream(stream, &output, &input);
+            if(zstd->isError(hint)){
+                m_error = string("damaged zstd input: ") + zstd->getErrorName(hint);
+                ok = false;
+                break;
+            }
+            used = output.pos;
+            if(used == chunk.size()){
+                if(!push(chunk)){
+                    zstd->freeDStream(stream);
+                    return true;
+                }
+                chunk.resize(INPUT_CHUNK_SIZE);
+                used = 0;
+            }
+        }
+    }
+    // Flush what the decoder still holds once the input has ended
+    while(ok){
+        ZstdInBuffer input = {in.data(), 0, 0};
+        ZstdOutBuffer output = {chunk.data(), chunk.size(), used};
+        size_t flushed = zstd->decompressStream(stream, &output, &input);
+        if(zstd->isError(flushed) || output.pos == used){
+            break;
+        }
+        hint = flushed;
+        used = output.pos;
+        if(used == chunk.size()){
+            if(!push(chunk)){
+                break;
+            }
+            chunk.resize(INPUT_CHUNK_SIZE);
+            used = 0;
+        }
+    }
+    // IF: Input ended inside a frame, part of it is missing
+    if(ok && hint != 0){
+        m_error = "truncated zstd input";
+        ok = false;
+    }
+    zstd->freeDStream(stream);
+    chunk.resize(used);
+    if(!chunk.empty()){
+        push(chunk);
+    }
+    return ok;
+}
+
+bool InputStream::open(string filename){
+    if(!m_buffer.open(filename)){
+        setstate(ios::failbit);
+        return false;
+    }
+    clear();
+    return true;
+}
+
+Compression InputStream::getCompression() const {
+    return m_buffer.getCompression();
+}
+
+string InputStream::getError(){
+    return m_buffer.getError();
+}
@@ -0,0 +1,115 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the input stream class.
+    @file inputStream.hpp
+
+    This class reads an input file, or standard
+    input for "-", as a stream of text, inflating
+    gzip or zstd input on the fly. The format is
+    detected from the first bytes, not the name.
+    A reader thread reads and decompresses into a
+    fixed number of chunks while the caller parses
+    the previous ones, so memory stays bounded
+    whatever the size of the input. zstd is loaded
+    at run time (libzstd.so.1), so it is only needed
+    when zstd input is read. */
+
+#ifndef INPUT_STREAM_H
+#define INPUT_STREAM_H
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Bytes of decompressed text per chunk. */
+#define INPUT_CHUNK_SIZE (256 * 1024)
+
+/* Chunks filled ahead of the parser at most. */
+#define INPUT_CHUNKS_AHEAD 4
+
+enum Compression {
+    COMPRESSION_NONE, COMPRESSION_GZIP, COMPRESSION_ZSTD
+};
+
+/* Stream buffer fed by the reader thread. */
+class InputBuffer : public std::streambuf {
+public:
+    InputBuffer();
+    ~InputBuffer();
+    InputBuffer(const InputBuffer &) = delete;
+    InputBuffer & operator=(const InputBuffer &) = delete;
+
+    /* Opens a file ("-" for standard input) and starts the reader thread.
+       @returns True if successful; false, otherwise. */
+    bool open(std::string filename);
+
+    /* Gets the compression detected by open. */
+    Compression getCompression() const;
+
+    /* Gets why reading stopped early; empty if it did not. */
+    std::string getError();
+
+protected:
+    /* Moves on to the next filled chunk, waiting for it if need be. */
+    int_type underflow() override;
+
+private:
+    int m_fd;
+    bool m_ownsFd;
+    Compression m_compression;
+
+    /* Bytes read by open to detect the format, not yet decompressed. */
+    std::vector<char> m_head;
+
+    std::thread m_reader;
+    std::mutex m_lock;
+    std::condition_variable m_filled;
+    std::condition_variable m_drained;
+    std::deque<std::vector<char>> m_chunks;
+    std::vector<char> m_current;
+    bool m_done;
+    bool m_stop;
+    std::string m_error;
+
+    /* Body of the reader thread: reads, decompresses and queues chunks. */
+    void read();
+
+    /* Reads raw bytes, starting with m_head.
+       @returns Number of bytes read; 0 at end of input, -1 on error. */
+    long readRaw(char * buffer, std::size_t size);
+
+    /* Queues a filled chunk, waiting while INPUT_CHUNKS_AHEAD are queued.
+       @returns False if the stream is being closed. */
+    bool push(std::vector<char> & chunk);
+
+    /* Reader HELPERS: copy or decompress the whole input into chunks.
+       @returns False with m_error set if the input is damaged. */
+    bool copyPlain();
+    bool inflateGzip();
+    bool decompressZstd();
+};
+
+class InputStream : public std::istream {
+public:
+    InputStream() : std::istream(&m_buffer) { }
+
+    /* Opens a file, or standard input for "-".
+       @returns True if successful; false, otherwise. */
+    bool open(std::string filename);
+
+    Compression getCompression() const;
+
+    /* Gets why reading stopped early (e.g. damaged compressed input);
+       empty if the whole input was read. */
+    std::string getError();
+
+private:
+    InputBuffer m_buffer;
+};
+#endif
@@ -11,6 +11,7 @@
 using namespace std;
 
 void LocalCover::addRule(Rule * rule){
+    rule->id = m_nextId++;
     m_rules[rule->id] = rule;
 }
 
@@ -18,20 +19,6 @@ void LocalCover::removeRule(Rule * rule){
     m_rules.erase(rule->id);
 }
 
-string LocalCover::classifyRule(vector<AV *> avBlocks, Rule * rule) const {
-    stringstream result;
-    
-    // Intersect all attribute blocks
-    set<int> matchLHS = rule->getBlock(avBlocks);
-
-    // Intersect all attribute blocks with concept block
-    set<int> matchCase = setIntersection(rule->getBlock(avBlocks), m_concept->getBlock());
-
-    result << rule->size() << ", " << matchCase.size() << ", " << matchLHS.size() << endl;
-
-    return result.str();
-}
-
 set<int> LocalCover::getCoveredConditions(vector<AV *> avBlocks) const {
     vector<set<int>> blocks;
     for( auto const & [id, rule] : m_rules){
@@ -40,31 +27,73 @@ set<int> LocalCover::getCoveredConditions(vector<AV *> avBlocks) const {
     return (setsUnion(blocks));
 }
 
-void LocalCover::dropRules(vector<AV *> avBlocks, set<int> B){
+size_t LocalCover::dropRules(vector<AV *> avBlocks, set<int> B, const set<int> * candidates){
     // IF: Covering has one or less rule
     if(m_rules.size() <= 1){
-        return;
+        return 0;
     }
+    size_t dropped = 0;
     // Else: Covering has at least two rules
     std::map<int, Rule *>::iterator iter;
     for(iter = m_rules.begin(); iter != m_rules.end();){
+        // IF: Rule may not be dropped
+        if(candidates && !candidates->count(iter->first)){
+            iter++;
+            continue;
+        }
         LocalCover lc = *this;
         lc.removeRule((*iter).second);
         if(lc.getCoveredConditions(avBlocks) == B){
+            delete iter->second;
             iter = m_rules.erase(iter);
+            dropped++;
         } else {
             iter++;
         }
     }
+    return dropped;
+}
+
+size_t LocalCover::size() const {
+    return m_rules.size();
+}
+
+vector<Rule *> LocalCover::getRules() const {
+    vector<Rule *> rules;
+    for(auto const & [id, rule] : m_rules){
+        rules.push_back(rule);
+    }
+    return rules;
+}
+
+Concept * LocalCover::getConcept() const {
+    return m_concept;
 }
 
-string LocalCover::toString(std::vector<AV *> avBlocks) const {
-    stringstream result;
-    // FOR: Each rule, print to file
+void LocalCover::write(ostream & file, const vector<AV *> & avBlocks, vector<string> & labels,
+                       const vector<size_t> * weights) const {
+    string conceptLabel = m_concept->labelString();
+    set<int> B = m_concept->getBlock();
+
+    // FOR: Each rule, print (Specificity, Strength, Size) and its conditions
     for(auto const & [id, rule] : m_rules){
-        result << classifyRule(avBlocks, rule);
-        result << rule->toString(avBlocks);
-        result << " -> " << m_concept->labelString() << endl;
+        set<int> block = rule->getBlock(avBlocks);
+        size_t strength = 0;
+        for(int x : block){
+            if(B.count(x)){
+                strength += weights ? (*weights)[x] : 1;
+            }
+        }
+        file << rule->size() << ", " << strength << ", " << weightedSize(block, weights) << '\n';
+
+        bool first = true;
+        for(int c : rule->getConditions()){
+            if(labels[c].empty()){
+                labels[c] = avBlocks[c]->labelString();
+            }
+            file << (first ? "" : " & ") << labels[c];
+            first = false;
+        }
+        file << " -> " << conceptLabel << '\n';
     }
-    return result.str();
-}
\ No newline at end of file
+}
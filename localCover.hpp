@@ -13,36 +13,54 @@
 #include "rule.hpp"
 #include "utils.hpp"
 #include <map>
+#include <ostream>
 #include <set>
 #include <vector>
 
 class LocalCover {
 public:
     LocalCover(Concept * concept)
-        : m_concept(concept) { }
+        : m_concept(concept), m_nextId(0) { }
 
-    /* Adds a single rule to the covering. */  
+    /* Adds a single rule to the covering, after those added before it. */  
     void addRule(Rule * rule);
     
     /* Removes a single rule from the covering. */
     void removeRule(Rule * rule);
 
-    /* Gets the classification string for a rule: (Specificity, Strength, Size) */
-    std::string classifyRule(std::vector<AV *> avBlocks, Rule * rule) const;
-
     /* Retrieves the union of all rule blocks. */
     set<int> getCoveredConditions(std::vector<AV *> avBlocks) const;
 
-    /* Optimizes covering by removing unnecessary rules. */
-    void dropRules(std::vector<AV *> avBlocks, std::set<int> B);
+    /* Optimizes covering by removing (and deleting) unnecessary rules.
+       @param candidates, if given, only rules with these IDs may be dropped.
+       @returns Number of rules dropped. */
+    std::size_t dropRules(std::vector<AV *> avBlocks, std::set<int> B,
+                          const std::set<int> * candidates = nullptr);
+
+    /* Gets number of rules in the covering. */
+    std::size_t size() const;
+
+    /* Gets the rules, in order of addition. */
+    std::vector<Rule *> getRules() const;
 
-    /* Converts covering to string. */
-    std::string toString(std::vector<AV *> avBlocks) const;
+    /* Gets the concept being covered. */
+    Concept * getConcept() const;
+
+    /* Writes the covering to a stream as it goes: per rule, a line of
+       (Specificity, Strength, Size), then its conditions -> concept.
+       Each rule's block is computed once for its numbers.
+       @param labels, label of each block, shared across coverings; empty
+              entries are formatted on first use. */
+    void write(std::ostream & file, const std::vector<AV *> & avBlocks, std::vector<std::string> & labels,
+               const std::vector<std::size_t> * weights = nullptr) const;
 private:
     /* Set of indices of selected conditions for rule. */
     std::map<int, Rule *> m_rules;
 
     /* Concept for the local covering. */
     Concept * m_concept;
+
+    /* ID of the next rule added; rules are kept in order of addition. */
+    int m_nextId;
 };
 #endif
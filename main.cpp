@@ -2,21 +2,263 @@
 // Project: MLEM2 Rule Induction
 // Date: 11/20/2019
 
+#include "batch.hpp"
+#include "binaryRuleset.hpp"
+#include "daemon.hpp"
 #include "executive.hpp"
+#include "memTracker.hpp"
+#include "shardCoordinator.hpp"
+#include "trace.hpp"
+#include <cstdlib>
 #include <iostream>
 #include <stdexcept>
 #include <string>
 #include <limits>
+#include <unistd.h>
 
 using namespace std;
 
-/* Utility function */
+/* Utility functions */
 string getFile(string type);
+void runInteractive(Stats * stats, const Options & options, ResultCache * cache);
+int submitJobs(string socket, string requestLine, vector<string> files);
+bool absolutePath(string path, bool parentOnly, string & absolute);
+void printUsage(string program);
 
 int main(int argc, char* argv[]){
+    string statsFile, memFile, traceFile, manifest, daemonSocket, submitSocket, requestLine;
+    string shardSnapshot, shardFile, resultCacheDir;
+    vector<string> files;
+    size_t numThreads = 0, cacheMB = 1024, resultCacheMB = 256;
+    Stats stats;
+    Options options;
+
+    // FOR: Each command-line option
+    for(int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if(arg == "--stats" && i + 1 < argc){
+            statsFile = argv[++i];
+        } else if(arg == "--mem-report" && i + 1 < argc){
+            memFile = argv[++i];
+        } else if(arg == "--trace" && i + 1 < argc){
+            traceFile = argv[++i];
+            Tracer::enable();
+        } else if(arg == "--manifest" && i + 1 < argc){
+            manifest = argv[++i];
+        } else if(arg == "--jobs" && i + 1 < argc){
+            numThreads = atoi(argv[++i]);
+        } else if(arg == "--cv" && i + 1 < argc){
+            options.cvFolds = atoi(argv[++i]);
+        } else if(arg == "--cv-cutpoints" && i + 1 < argc){
+            string mode = argv[++i];
+            if(mode == "shared"){
+                options.cvCutpoints = CV_SHARED_CUTPOINTS;
+            } else if(mode == "recompute"){
+                options.cvCutpoints = CV_RECOMPUTE_CUTPOINTS;
+            } else {
+                cerr << "Unknown cutpoint mode: " << mode << endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if(arg == "--cutpoints" && i + 1 < argc){
+            string mode = argv[++i];
+            if(mode == "all"){
+                options.cutpointMode = CUT_ALL;
+            } else if(mode == "boundary"){
+                options.cutpointMode = CUT_BOUNDARY;
+            } else if(mode == "quantile"){
+                options.cutpointMode = CUT_QUANTILE;
+            } else {
+                cerr << "Unknown cutpoint mode: " << mode << endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if(arg == "--max-cutpoints" && i + 1 < argc){
+            options.maxCutpoints = atoi(argv[++i]);
+        } else if(arg == "--compare-cutpoints"){
+            options.compareCutpoints = true;
+        } else if(arg == "--selection" && i + 1 < argc){
+            string mode = argv[++i];
+            if(mode == "full"){
+                options.selection = SELECT_FULL;
+            } else if(mode == "bounded"){
+                options.selection = SELECT_BOUNDED;
+            } else {
+                cerr << "Unknown selection strategy: " << mode << endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if(arg == "--block-store" && i + 1 < argc){
+            options.blockStoreDir = argv[++i];
+        } else if(arg == "--block-store-mb" && i + 1 < argc){
+            options.blockStoreMB = atoi(argv[++i]);
+        } else if(arg == "--sample" && i + 1 < argc){
+            options.sampleFraction = atof(argv[++i]);
+            if(options.sampleFraction <= 0 || options.sampleFraction >= 1){
+                cerr << "Sample fraction must be between 0 and 1: " << argv[i] << endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if(arg == "--speculate" && i + 1 < argc){
+            options.speculativeSeeds = atoi(argv[++i]);
+        } else if(arg == "--compare-speculation"){
+            options.compareSpeculation = true;
+        } else if(arg == "--workers" && i + 1 < argc){
+            options.numWorkers = atoi(argv[++i]);
+        } else if(arg == "--shard-worker" && i + 2 < argc){
+            shardSnapshot = argv[++i];
+            shardFile = argv[++i];
+        } else if(arg == "--snapshot"){
+            options.snapshot = true;
+        } else if(arg == "--deadline" && i + 1 < argc){
+            options.deadlineSeconds = atof(argv[++i]);
+        } else if(arg == "--checkpoint"){
+            options.checkpoint = true;
+        } else if(arg == "--checkpoint-seconds" && i + 1 < argc){
+            options.checkpointSeconds = atof(argv[++i]);
+        } else if(arg == "--binary-rules"){
+            options.binaryRules = true;
+        } else if(arg == "--dump-rules" && i + 1 < argc){
+            BinaryRuleset ruleset;
+            if(!ruleset.open(argv[++i])){
+                cerr << "Not a binary ruleset: " << argv[i] << endl;
+                return 1;
+            }
+            ruleset.writeText(cout);
+            return 0;
+        } else if(arg == "--collapse-duplicates"){
+            options.collapseDuplicates = true;
+        } else if(arg == "--renumber-cases"){
+            options.renumberCases = true;
+        } else if(arg == "--append" && i + 1 < argc){
+            options.appendFile = argv[++i];
+        } else if(arg == "--verify"){
+            options.verify = true;
+        } else if(arg == "--result-cache" && i + 1 < argc){
+            resultCacheDir = argv[++i];
+        } else if(arg == "--result-cache-mb" && i + 1 < argc){
+            resultCacheMB = atoi(argv[++i]);
+        } else if(arg == "--daemon" && i + 1 < argc){
+            daemonSocket = argv[++i];
+        } else if(arg == "--cache-mb" && i + 1 < argc){
+            cacheMB = atoi(argv[++i]);
+        } else if(arg == "--submit" && i + 1 < argc){
+            submitSocket = argv[++i];
+        } else if(arg == "--request" && i + 2 < argc){
+            submitSocket = argv[++i];
+            requestLine = argv[++i];
+        } else if(arg.size() > 2 && arg.compare(0, 2, "--") == 0){
+            cerr << "Unknown option: " << arg << endl;
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    options.numThreads = numThreads;
+    // IF: Appending, the cases must keep their numbers and weights as loaded
+    if(!options.appendFile.empty() && (options.collapseDuplicates || options.renumberCases)){
+        cerr << "--append cannot be combined with --collapse-duplicates or --renumber-cases" << endl;
+        return 1;
+    }
+    if(files.size() % 2 != 0){
+        cerr << "Input file without output file: " << files.back() << endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // IF: Memory report requested, restart with tracking enabled from the first allocation
+    if(!memFile.empty() && !MemTracker::isEnabled()){
+        setenv("MLEM2_MEMTRACK", "1", 1);
+        execv("/proc/self/exe", argv);
+        cerr << "Unable to enable memory tracking; continuing without it." << endl;
+    }
+    if(MemTracker::isEnabled()){
+        MemTracker::installSignalHandler();
+    }
+
+    // IF: Started by a coordinator, induce the concepts of one shard
+    if(!shardFile.empty()){
+        return ShardCoordinator::runWorker(shardSnapshot, shardFile, options);
+    }
+    // IF: Serving jobs over a socket
+    if(!daemonSocket.empty()){
+        // Jobs share cached blocks and write only the ruleset, so these cannot apply
+        if(options.cvFolds > 0 || !options.appendFile.empty() || options.verify || options.numWorkers > 1
+           || options.checkpoint || options.binaryRules || options.snapshot || !options.blockStoreDir.empty()
+           || options.compareCutpoints || options.compareSpeculation){
+            cerr << "--daemon cannot be combined with --cv, --append, --verify, --workers, --checkpoint, "
+                 << "--binary-rules, --snapshot, --block-store or the --compare options" << endl;
+            return 1;
+        }
+        Daemon daemon(daemonSocket, cacheMB << 20, numThreads, options);
+        return daemon.run() ? 0 : 1;
+    }
+    // IF: Sending jobs to a running daemon
+    if(!submitSocket.empty()){
+        return submitJobs(submitSocket, requestLine, files);
+    }
+
+    Stats * statsPtr = statsFile.empty() ? nullptr : &stats;
+    int status = 0;
+
+    // IF: Result cache requested, open (or create) its directory
+    ResultCache resultCache(resultCacheDir, resultCacheMB << 20);
+    ResultCache * cachePtr = nullptr;
+    if(!resultCacheDir.empty()){
+        if(resultCache.create()){
+            cachePtr = &resultCache;
+        } else {
+            cerr << "Unable to use result cache directory: " << resultCacheDir << endl;
+        }
+    }
+
+    // IF: No jobs given, fall back to prompting for one input and output file
+    if(files.empty() && manifest.empty()){
+        runInteractive(statsPtr, options, cachePtr);
+    } else {
+        Batch batch(options);
+        batch.setResultCache(cachePtr);
+        if(!manifest.empty() && !batch.loadManifest(manifest)){
+            cerr << "Unable to read manifest: " << manifest << endl;
+            return 1;
+        }
+        for(unsigned i = 0; i < files.size(); i += 2){
+            batch.addJob(files[i], files[i + 1]);
+        }
+        size_t failed = batch.run(numThreads, statsPtr);
+        batch.printStatus(cout);
+        if(failed > 0){
+            cerr << failed << " of " << batch.size() << " jobs failed." << endl;
+            status = 2;
+        }
+    }
+    if(cachePtr){
+        resultCache.report(cout);
+    }
+
+    if(statsPtr && !stats.writeJson(statsFile)){
+        cerr << "Unable to write stats file: " << statsFile << endl;
+        return 1;
+    }
+    if(!traceFile.empty() && !Tracer::writeJson(traceFile)){
+        cerr << "Unable to write trace file: " << traceFile << endl;
+        return 1;
+    }
+    if(!memFile.empty() && !MemTracker::writeReport(memFile)){
+        cerr << "Unable to write memory report: " << memFile << endl;
+        return 1;
+    }
+    return status;
+}
+
+void runInteractive(Stats * stats, const Options & options, ResultCache * cache){
     bool validFile = false;
     string inFile, outFile;
     Executive exec;
+    exec.setStats(stats);
+    exec.setOptions(options);
+    exec.setResultCache(cache);
 
     // Request input file from user
     while(!validFile){
@@ -30,7 +272,104 @@ int main(int argc, char* argv[]){
         outFile = getFile("output");
         validFile = exec.generateOutFile(outFile);
     }
-    return 0;
+}
+
+int submitJobs(string socket, string requestLine, vector<string> files){
+    int status = 0;
+    vector<string> lines;
+    if(!requestLine.empty()){
+        lines.push_back(requestLine);
+    }
+    // FOR: Each job, send absolute paths; the daemon runs in its own directory
+    for(unsigned i = 0; i < files.size(); i += 2){
+        string in, out;
+        if(!absolutePath(files[i], false, in) || !absolutePath(files[i + 1], true, out)){
+            cout << "ERROR unable to resolve " << files[i] << " or " << files[i + 1] << endl;
+            status = 2;
+            continue;
+        }
+        lines.push_back("INDUCE " + in + " " + out);
+    }
+    for(string line : lines){
+        string reply = Daemon::request(socket, line);
+        cout << reply << endl;
+        if(reply.compare(0, 2, "OK") != 0){
+            status = 2;
+        }
+    }
+    return status;
+}
+
+/* Resolves a path against the current directory, following symbolic links.
+   @param parentOnly, resolve only the directory, for a file that may not exist yet.
+   @returns False if the path (or its directory) does not exist. */
+bool absolutePath(string path, bool parentOnly, string & absolute){
+    string dir = path, name;
+    if(parentOnly){
+        size_t slash = path.find_last_of('/');
+        dir = slash == string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        name = slash == string::npos ? path : path.substr(slash + 1);
+    }
+    char * resolved = realpath(dir.c_str(), nullptr);
+    if(!resolved){
+        return false;
+    }
+    absolute = resolved;
+    free(resolved);
+    if(parentOnly){
+        absolute += (absolute == "/" ? "" : "/") + name;
+    }
+    return true;
+}
+
+void printUsage(string program){
+    cerr << "Usage: " << program << " [options] [input output ...]" << endl
+         << "  With no input/output pairs or manifest, prompts for one of each." << endl
+         << "  Inputs may be gzip or zstd compressed; \"-\" reads the input from stdin." << endl
+         << "  --manifest file      Read \"input output\" pairs, one per line" << endl
+         << "  --jobs n             Worker threads for batch jobs (default: one per core)" << endl
+         << "  --stats out.json     Write per-phase timing and counters" << endl
+         << "  --mem-report out.txt Write per-subsystem memory accounting" << endl
+         << "  --trace trace.json   Write a Chrome trace-event timeline" << endl
+         << "  --cv k               Write a k-fold cross-validation report instead of rules" << endl
+         << "  --cv-cutpoints mode  shared: cut once on all data; recompute (default): per fold" << endl
+         << "  --cutpoints mode     all (default): every midpoint; boundary: class boundaries only;" << endl
+         << "                       quantile: at most --max-cutpoints equal-frequency cuts" << endl
+         << "  --max-cutpoints n    Cap per attribute for quantile cutpoints (default: 256)" << endl
+         << "  --compare-cutpoints  Also induce with all cutpoints and print the differences" << endl
+         << "  --selection mode     full (default): count every candidate; bounded: branch and bound" << endl
+         << "  --block-store dir    Keep attribute-value blocks in a memory-mapped scratch file" << endl
+         << "                       in dir instead of in memory, and report its I/O" << endl
+         << "  --block-store-mb n   Drop mapped block store pages after about n MiB touched (1024)" << endl
+         << "  --sample f           Induce candidate rules on a fraction f of each concept first," << endl
+         << "                       keep those consistent on all cases, then cover the rest" << endl
+         << "  --speculate k        Build rules from k seeds of each concept at once on --jobs" << endl
+         << "                       threads, keeping those that still cover new cases" << endl
+         << "  --compare-speculation  Also induce one rule at a time and print the differences" << endl
+         << "  --workers n          Spread the concepts of each ruleset over n worker processes," << endl
+         << "                       largest first, handing data and rules over through files;" << endl
+         << "                       ignores --sample, --binary-rules, --checkpoint, --block-store" << endl
+         << "  --snapshot           Keep a binary snapshot of each input as <input>.snap and" << endl
+         << "                       load it instead of parsing while the input is unchanged" << endl
+         << "  --deadline s         Stop refining s seconds into each job: cover the rest with" << endl
+         << "                       quick rules, skip dropping, mark the ruleset partial" << endl
+         << "  --checkpoint         Save progress to <output>.ckpt and resume from it after" << endl
+         << "                       a restart; refused if the input or options changed" << endl
+         << "  --checkpoint-seconds n  Least seconds between checkpoint saves (default: 60)" << endl
+         << "  --binary-rules       Also write each ruleset in binary to <output>.bin" << endl
+         << "  --dump-rules file    Print a binary ruleset in the text format and exit" << endl
+         << "  --collapse-duplicates  Induce on distinct cases weighted by multiplicity" << endl
+         << "  --renumber-cases     Number cases by decision, then attribute values, so concepts" << endl
+         << "                       and blocks are runs of consecutive cases; rules do not change" << endl
+         << "  --append cases.txt   Append these cases after inducing and repair the rules" << endl
+         << "  --verify             Check every concept's rules form a valid local covering" << endl
+         << "  --result-cache dir   Reuse rulesets of datasets induced before with the same options," << endl
+         << "                       keyed by a hash of the parsed tokens, kept in dir" << endl
+         << "  --result-cache-mb n  Evict least recently used cached rulesets past n MiB (256)" << endl
+         << "  --daemon socket      Serve jobs on a UNIX socket, keeping datasets cached" << endl
+         << "  --cache-mb n         Daemon cache budget in MiB (default: 1024)" << endl
+         << "  --submit socket      Send the input/output pairs to a running daemon" << endl
+         << "  --request socket line  Send one raw request (STATUS, SHUTDOWN) to a daemon" << endl;
 }
 
 string getFile(string type){
@@ -44,4 +383,4 @@ string getFile(string type){
         cin >> file;
     }
     return file;
-}
\ No newline at end of file
+}
@@ -0,0 +1,94 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the global allocation hooks.
+    @file memHooks.cpp
+
+    Replaces the global operator new and delete so
+    the memory tracker can attribute allocations.
+    When tracking is enabled each block is prefixed
+    with a header holding its size and subsystem. */
+
+#include "memTracker.hpp"
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+/* Keeps the user pointer aligned to max_align_t. */
+struct alignas(alignof(max_align_t)) MemHeader {
+    size_t size;
+    MemSubsystem subsystem;
+};
+
+static void * trackedAlloc(size_t size){
+    if(!MemTracker::isEnabled()){
+        return malloc(size ? size : 1);
+    }
+    MemHeader * header = (MemHeader *) malloc(sizeof(MemHeader) + size);
+    if(!header){
+        return nullptr;
+    }
+    header->size = size;
+    header->subsystem = MemTracker::current();
+    MemTracker::recordAlloc(header->subsystem, size);
+    return header + 1;
+}
+
+static void trackedFree(void * ptr){
+    if(!ptr){
+        return;
+    }
+    if(!MemTracker::isEnabled()){
+        free(ptr);
+        return;
+    }
+    MemHeader * header = ((MemHeader *) ptr) - 1;
+    MemTracker::recordFree(header->subsystem, header->size);
+    free(header);
+}
+
+void * operator new(size_t size){
+    void * ptr = trackedAlloc(size);
+    if(!ptr){
+        throw bad_alloc();
+    }
+    return ptr;
+}
+
+void * operator new[](size_t size){
+    return operator new(size);
+}
+
+void * operator new(size_t size, const nothrow_t &) noexcept {
+    return trackedAlloc(size);
+}
+
+void * operator new[](size_t size, const nothrow_t &) noexcept {
+    return trackedAlloc(size);
+}
+
+void operator delete(void * ptr) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete[](void * ptr) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete[](void * ptr, size_t) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete(void * ptr, const nothrow_t &) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete[](void * ptr, const nothrow_t &) noexcept {
+    trackedFree(ptr);
+}
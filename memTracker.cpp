@@ -0,0 +1,166 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the memory tracker.
+    @file memTracker.cpp
+
+    This class attributes heap allocations to
+    subsystems. The allocation hooks themselves
+    live in memHooks.cpp. */
+
+#include "memTracker.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char * SUBSYSTEM_NAMES[NUM_MEM_SUBSYSTEMS] = {
+    "other", "dataset", "av_blocks", "concepts",
+    "induction", "covers", "output"
+};
+
+struct MemCounters {
+    atomic<uint64_t> allocs;
+    atomic<uint64_t> frees;
+    atomic<int64_t> live;
+    atomic<int64_t> peak;
+};
+
+static MemCounters counters[NUM_MEM_SUBSYSTEMS];
+static MemCounters total;
+static thread_local MemSubsystem currentSubsystem = MEM_OTHER;
+
+/* Raises peak to at least value. */
+static void updatePeak(atomic<int64_t> & peak, int64_t value){
+    int64_t old = peak.load(memory_order_relaxed);
+    while(value > old && !peak.compare_exchange_weak(old, value, memory_order_relaxed)){ }
+}
+
+/* Appends text to buffer without allocating. */
+static size_t append(char * buffer, size_t pos, size_t cap, const char * text){
+    while(*text && pos < cap){
+        buffer[pos++] = *text++;
+    }
+    return pos;
+}
+
+/* Appends a right-aligned number to buffer without allocating. */
+static size_t appendNumber(char * buffer, size_t pos, size_t cap, int64_t value, int width){
+    char digits[24];
+    int len = 0;
+    bool negative = value < 0;
+    uint64_t v = negative ? -(uint64_t) value : value;
+    do {
+        digits[len++] = '0' + (v % 10);
+        v /= 10;
+    } while(v > 0);
+    if(negative){
+        digits[len++] = '-';
+    }
+    for(int i = len; i < width && pos < cap; i++){
+        buffer[pos++] = ' ';
+    }
+    while(len > 0 && pos < cap){
+        buffer[pos++] = digits[--len];
+    }
+    return pos;
+}
+
+/* Appends one line of the report. */
+static size_t appendRow(char * buffer, size_t pos, size_t cap, const char * name, MemCounters & c){
+    pos = append(buffer, pos, cap, "  ");
+    pos = append(buffer, pos, cap, name);
+    for(size_t i = strlen(name); i < 10; i++){
+        pos = append(buffer, pos, cap, " ");
+    }
+    pos = appendNumber(buffer, pos, cap, c.allocs.load(memory_order_relaxed), 12);
+    pos = appendNumber(buffer, pos, cap, c.frees.load(memory_order_relaxed), 12);
+    pos = appendNumber(buffer, pos, cap, c.live.load(memory_order_relaxed), 14);
+    pos = appendNumber(buffer, pos, cap, c.peak.load(memory_order_relaxed), 14);
+    return append(buffer, pos, cap, "\n");
+}
+
+static void handleSignal(int){
+    MemTracker::report(STDERR_FILENO);
+}
+
+bool MemTracker::isEnabled(){
+    static const bool enabled = getenv("MLEM2_MEMTRACK") != nullptr;
+    return enabled;
+}
+
+MemSubsystem MemTracker::current(){
+    return currentSubsystem;
+}
+
+MemSubsystem MemTracker::setCurrent(MemSubsystem subsystem){
+    MemSubsystem previous = currentSubsystem;
+    currentSubsystem = subsystem;
+    return previous;
+}
+
+void MemTracker::recordAlloc(MemSubsystem subsystem, size_t bytes){
+    MemCounters & c = counters[subsystem];
+    c.allocs.fetch_add(1, memory_order_relaxed);
+    updatePeak(c.peak, c.live.fetch_add(bytes, memory_order_relaxed) + bytes);
+    total.allocs.fetch_add(1, memory_order_relaxed);
+    updatePeak(total.peak, total.live.fetch_add(bytes, memory_order_relaxed) + bytes);
+}
+
+void MemTracker::recordFree(MemSubsystem subsystem, size_t bytes){
+    MemCounters & c = counters[subsystem];
+    c.frees.fetch_add(1, memory_order_relaxed);
+    c.live.fetch_sub(bytes, memory_order_relaxed);
+    total.frees.fetch_add(1, memory_order_relaxed);
+    total.live.fetch_sub(bytes, memory_order_relaxed);
+}
+
+void MemTracker::report(int fd){
+    char buffer[2048];
+    size_t cap = sizeof(buffer), pos = 0;
+    if(!isEnabled()){
+        pos = append(buffer, pos, cap, "Memory tracking disabled (set MLEM2_MEMTRACK=1).\n");
+    } else {
+        pos = append(buffer, pos, cap, "  subsystem       allocs       frees    live_bytes    peak_bytes\n");
+        for(unsigned i = 0; i < NUM_MEM_SUBSYSTEMS; i++){
+            pos = appendRow(buffer, pos, cap, SUBSYSTEM_NAMES[i], counters[i]);
+        }
+        pos = appendRow(buffer, pos, cap, "total", total);
+    }
+    // Partial writes are retried; errors are ignored
+    size_t written = 0;
+    while(written < pos){
+        ssize_t n = write(fd, buffer + written, pos - written);
+        if(n <= 0){
+            break;
+        }
+        written += n;
+    }
+}
+
+bool MemTracker::writeReport(string filename){
+    int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    // Unable to open file; Signal with boolean
+    if(fd < 0){
+        return false;
+    }
+    report(fd);
+    close(fd);
+    return true;
+}
+
+void MemTracker::installSignalHandler(){
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleSignal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR1, &action, nullptr);
+}
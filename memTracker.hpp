@@ -0,0 +1,62 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the memory tracker.
+    @file memTracker.hpp
+
+    This class attributes heap allocations to
+    subsystems. Tracking is opt-in: it is decided
+    once, at the first allocation, by the
+    MLEM2_MEMTRACK environment variable, because
+    every tracked block carries a small header. */
+
+#ifndef MEM_TRACKER_H
+#define MEM_TRACKER_H
+#include <cstddef>
+#include <string>
+
+enum MemSubsystem {
+    MEM_OTHER, MEM_DATASET, MEM_BLOCKS, MEM_CONCEPTS,
+    MEM_INDUCTION, MEM_COVERS, MEM_OUTPUT, NUM_MEM_SUBSYSTEMS
+};
+
+class MemTracker {
+public:
+    /* Checks if allocations are being tracked. */
+    static bool isEnabled();
+
+    /* Gets the subsystem new allocations are charged to on this thread. */
+    static MemSubsystem current();
+
+    /* Sets the subsystem for this thread.
+       @returns The previous subsystem. */
+    static MemSubsystem setCurrent(MemSubsystem subsystem);
+
+    /* Hooks called by the global allocation functions. */
+    static void recordAlloc(MemSubsystem subsystem, std::size_t bytes);
+    static void recordFree(MemSubsystem subsystem, std::size_t bytes);
+
+    /* Writes the report to a file descriptor. Async-signal-safe. */
+    static void report(int fd);
+
+    /* Writes the report to a file.
+       @returns True if file write is successful; false, otherwise. */
+    static bool writeReport(std::string filename);
+
+    /* Prints the report to stderr whenever SIGUSR1 is received. */
+    static void installSignalHandler();
+};
+
+/* Charges allocations made during its lifetime to a subsystem. */
+class MemScope {
+public:
+    MemScope(MemSubsystem subsystem)
+        : m_previous(MemTracker::setCurrent(subsystem)) { }
+    ~MemScope(){
+        MemTracker::setCurrent(m_previous);
+    }
+private:
+    MemSubsystem m_previous;
+};
+#endif
@@ -0,0 +1,88 @@
+/* Author: Kristi Daigh
+   Project: MLEM2 Rule Induction
+   Date: 11/20/2019 */
+
+/** C interface of libmlem2.
+    @file mlem2.h
+
+    A thin C wrapper around RuleInducer (see
+    ruleInducer.hpp). Strings passed in are copied;
+    strings and arrays handed out belong to the
+    ruleset and live until it is freed. Functions
+    returning int return 1 on success, 0 on failure. */
+
+#ifndef MLEM2_H
+#define MLEM2_H
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mlem2_inducer mlem2_inducer;
+typedef struct mlem2_ruleset mlem2_ruleset;
+
+enum mlem2_cutpoints {
+    MLEM2_CUT_ALL, MLEM2_CUT_BOUNDARY, MLEM2_CUT_QUANTILE
+};
+
+typedef struct {
+    int cutpoints;              /* enum mlem2_cutpoints */
+    size_t max_cutpoints;       /* cap per attribute for MLEM2_CUT_QUANTILE */
+    int bounded_selection;      /* nonzero: branch-and-bound condition selection */
+    int collapse_duplicates;    /* nonzero: induce on distinct cases, weighted */
+    size_t speculative_seeds;   /* 0 or 1: one rule at a time */
+    size_t num_threads;         /* for speculation; 0 is one per core */
+    double deadline_seconds;    /* 0: no deadline */
+} mlem2_options;
+
+typedef struct {
+    const char * attribute;
+    int numeric;
+    const char * value;         /* symbolic value; "" if numeric */
+    float lower_bound;          /* numeric interval; 0 if symbolic */
+    float upper_bound;
+} mlem2_condition;
+
+typedef struct {
+    const mlem2_condition * conditions;
+    size_t num_conditions;
+    const char * decision;
+    const char * value;
+    size_t specificity;
+    size_t strength;
+    size_t size;
+} mlem2_rule;
+
+/* Fills in the defaults (all cutpoints, full selection, no speculation). */
+void mlem2_default_options(mlem2_options * options);
+
+/* Creates an inducer for cases with these attributes and decision. */
+mlem2_inducer * mlem2_inducer_create(const char * const * attributes, size_t num_attributes,
+                                     const char * decision);
+
+/* Sets one value per case for an attribute column; column num_attributes
+   is the decision. */
+int mlem2_inducer_set_column(mlem2_inducer * inducer, size_t col,
+                             const char * const * values, size_t num_cases);
+
+void mlem2_inducer_free(mlem2_inducer * inducer);
+
+/* Induces rules; safe to call from many threads at once, also on the same
+   inducer. Always returns a ruleset, to be freed; check mlem2_ruleset_error. */
+mlem2_ruleset * mlem2_induce(const mlem2_inducer * inducer, const mlem2_options * options);
+
+/* Gets why induction failed; NULL if it succeeded. */
+const char * mlem2_ruleset_error(const mlem2_ruleset * ruleset);
+
+size_t mlem2_ruleset_size(const mlem2_ruleset * ruleset);
+
+/* Gets a rule; NULL if index is out of range. */
+const mlem2_rule * mlem2_ruleset_rule(const mlem2_ruleset * ruleset, size_t index);
+
+void mlem2_ruleset_free(mlem2_ruleset * ruleset);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
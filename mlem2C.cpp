@@ -0,0 +1,104 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the C interface of libmlem2.
+    @file mlem2C.cpp
+
+    Wraps RuleInducer in opaque C handles. */
+
+#include "mlem2.h"
+#include "ruleInducer.hpp"
+#include <new>
+
+using namespace std;
+
+struct mlem2_inducer {
+    RuleInducer inducer;
+};
+
+struct mlem2_ruleset {
+    vector<InducedRule> rules;
+    vector<vector<mlem2_condition>> conditions;
+    vector<mlem2_rule> views;
+    string error;
+};
+
+void mlem2_default_options(mlem2_options * options){
+    Options defaults;
+    options->cutpoints = MLEM2_CUT_ALL;
+    options->max_cutpoints = defaults.maxCutpoints;
+    options->bounded_selection = 0;
+    options->collapse_duplicates = 0;
+    options->speculative_seeds = 0;
+    options->num_threads = 0;
+    options->deadline_seconds = 0;
+}
+
+mlem2_inducer * mlem2_inducer_create(const char * const * attributes, size_t num_attributes,
+                                     const char * decision){
+    vector<string> names(attributes, attributes + num_attributes);
+    return new (nothrow) mlem2_inducer{RuleInducer(names, decision)};
+}
+
+int mlem2_inducer_set_column(mlem2_inducer * inducer, size_t col,
+                             const char * const * values, size_t num_cases){
+    return inducer->inducer.setColumn(col, vector<string>(values, values + num_cases));
+}
+
+void mlem2_inducer_free(mlem2_inducer * inducer){
+    delete inducer;
+}
+
+mlem2_ruleset * mlem2_induce(const mlem2_inducer * inducer, const mlem2_options * options){
+    mlem2_options defaults;
+    if(!options){
+        mlem2_default_options(&defaults);
+        options = &defaults;
+    }
+    Options opts;
+    opts.cutpointMode = options->cutpoints == MLEM2_CUT_BOUNDARY ? CUT_BOUNDARY
+                        : options->cutpoints == MLEM2_CUT_QUANTILE ? CUT_QUANTILE : CUT_ALL;
+    opts.maxCutpoints = options->max_cutpoints;
+    opts.selection = options->bounded_selection ? SELECT_BOUNDED : SELECT_FULL;
+    opts.collapseDuplicates = options->collapse_duplicates != 0;
+    opts.speculativeSeeds = options->speculative_seeds;
+    opts.numThreads = options->num_threads;
+    opts.deadlineSeconds = options->deadline_seconds;
+
+    mlem2_ruleset * ruleset = new mlem2_ruleset();
+    if(!inducer->inducer.induce(opts, ruleset->rules, ruleset->error)){
+        ruleset->rules.clear();
+        return ruleset;
+    }
+
+    // Views point into the rules, which no longer move
+    ruleset->conditions.resize(ruleset->rules.size());
+    for(size_t i = 0; i < ruleset->rules.size(); i++){
+        const InducedRule & rule = ruleset->rules[i];
+        for(const RuleCondition & c : rule.conditions){
+            ruleset->conditions[i].push_back({c.attribute.c_str(), c.numeric, c.value.c_str(),
+                                              c.lowerBound, c.upperBound});
+        }
+        ruleset->views.push_back({ruleset->conditions[i].data(), ruleset->conditions[i].size(),
+                                  rule.decision.c_str(), rule.value.c_str(),
+                                  rule.specificity, rule.strength, rule.size});
+    }
+    return ruleset;
+}
+
+const char * mlem2_ruleset_error(const mlem2_ruleset * ruleset){
+    return ruleset->error.empty() ? nullptr : ruleset->error.c_str();
+}
+
+size_t mlem2_ruleset_size(const mlem2_ruleset * ruleset){
+    return ruleset->views.size();
+}
+
+const mlem2_rule * mlem2_ruleset_rule(const mlem2_ruleset * ruleset, size_t index){
+    return index < ruleset->views.size() ? &ruleset->views[index] : nullptr;
+}
+
+void mlem2_ruleset_free(mlem2_ruleset * ruleset){
+    delete ruleset;
+}
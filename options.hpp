@@ -0,0 +1,102 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for run options.
+    @file options.hpp
+
+    Settings chosen on the command line
+    that change what a job computes. */
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+#include <cstddef>
+#include <string>
+
+enum CutpointSharing {
+    CV_SHARED_CUTPOINTS, CV_RECOMPUTE_CUTPOINTS
+};
+
+enum CutpointMode {
+    CUT_ALL, CUT_BOUNDARY, CUT_QUANTILE
+};
+
+enum SelectionStrategy {
+    SELECT_FULL, SELECT_BOUNDED
+};
+
+struct Options {
+    /* Number of cross-validation folds; 0 induces a ruleset instead. */
+    std::size_t cvFolds = 0;
+
+    /* Whether folds reuse the full-data cutpoints or recompute their own. */
+    CutpointSharing cvCutpoints = CV_RECOMPUTE_CUTPOINTS;
+
+    /* Worker threads for work inside one job (e.g. folds); 0 is one per core. */
+    std::size_t numThreads = 0;
+
+    /* Which cutpoints numeric attributes are discretized with. */
+    CutpointMode cutpointMode = CUT_ALL;
+
+    /* Most cutpoints per numeric attribute in CUT_QUANTILE mode. */
+    std::size_t maxCutpoints = 256;
+
+    /* Whether to also run with all cutpoints and report the differences. */
+    bool compareCutpoints = false;
+
+    /* How MLEM2 evaluates candidate conditions; both choose the same ones. */
+    SelectionStrategy selection = SELECT_FULL;
+
+    /* Directory for an out-of-core block store; empty keeps blocks in memory. */
+    std::string blockStoreDir;
+
+    /* Bytes of block store pages touched before the mapped pages are dropped. */
+    std::size_t blockStoreMB = 1024;
+
+    /* Fraction of each concept to induce candidate rules on before the
+       full data; 0 induces on the full data only. */
+    double sampleFraction = 0;
+
+    /* Seeds of a concept's uncovered cases to build rules from at once,
+       on numThreads threads; 0 or 1 builds one rule at a time. */
+    std::size_t speculativeSeeds = 0;
+
+    /* Whether to also induce one rule at a time and report the differences. */
+    bool compareSpeculation = false;
+
+    /* Worker processes the concepts of a ruleset are spread over; 0 or 1
+       induces every concept in this process. */
+    std::size_t numWorkers = 0;
+
+    /* Seconds from the start of a job after which induction stops refining
+       and finishes with quick rules; 0 for no deadline. */
+    double deadlineSeconds = 0;
+
+    /* Whether to save progress to the output file plus ".ckpt" and resume
+       from it; the file is removed once the output is complete. */
+    bool checkpoint = false;
+
+    /* Least seconds between two checkpoint saves. */
+    double checkpointSeconds = 60;
+
+    /* Whether to also write the ruleset in binary, to the output file plus ".bin". */
+    bool binaryRules = false;
+
+    /* Whether to keep a binary snapshot of each input, as the input file plus ".snap",
+       and load it instead of parsing while the input is unchanged. */
+    bool snapshot = false;
+
+    /* Whether identical cases are collapsed into one weighted case on load. */
+    bool collapseDuplicates = false;
+
+    /* Whether cases are renumbered on load so that concepts and blocks are
+       runs of consecutive case numbers; the rules do not change. */
+    bool renumberCases = false;
+
+    /* Cases appended to the dataset after the initial induction; empty for none. */
+    std::string appendFile;
+
+    /* Whether to check the final ruleset is a valid local covering of every concept. */
+    bool verify = false;
+};
+#endif
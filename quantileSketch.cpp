@@ -0,0 +1,170 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the quantile sketch class.
+    @file quantileSketch.cpp
+
+    This class summarizes a stream of numbers in
+    a bounded number of (centroid, count) bins, as
+    in the streaming histogram of Ben-Haim and
+    Tom-Tov, and estimates quantiles from them. */
+
+#include "quantileSketch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <tuple>
+
+using namespace std;
+
+/* Values buffered per bin before folding them in. */
+#define BUFFER_FACTOR 8
+
+void QuantileSketch::add(double value){
+    m_buffer.push_back(value);
+    // A buffer several times the bin count amortizes the sort and compression
+    if(m_buffer.size() >= BUFFER_FACTOR * m_maxBins){
+        flush();
+    }
+}
+
+bool QuantileSketch::isExact(){
+    flush();
+    return m_exact;
+}
+
+const vector<pair<double, uint64_t>> & QuantileSketch::getBins(){
+    flush();
+    return m_bins;
+}
+
+void QuantileSketch::flush(){
+    if(m_buffer.empty()){
+        return;
+    }
+    // Sort the (small) buffer and merge it with the bins, counting equal values once
+    sort(m_buffer.begin(), m_buffer.end());
+    vector<pair<double, uint64_t>> bins;
+    bins.reserve(m_bins.size() + m_buffer.size());
+    size_t b = 0;
+    for(double value : m_buffer){
+        while(b < m_bins.size() && m_bins[b].first < value){
+            bins.push_back(m_bins[b++]);
+        }
+        if(b < m_bins.size() && m_bins[b].first == value){
+            bins.push_back(m_bins[b++]);
+        }
+        if(!bins.empty() && bins.back().first == value){
+            bins.back().second++;
+        } else {
+            bins.push_back(make_pair(value, (uint64_t) 1));
+        }
+    }
+    while(b < m_bins.size()){
+        bins.push_back(m_bins[b++]);
+    }
+    m_bins.swap(bins);
+    m_buffer.clear();
+    compress();
+}
+
+void QuantileSketch::compress(){
+    if(m_bins.size() <= m_maxBins){
+        return;
+    }
+    m_exact = false;
+
+    // Bins form a linked list; a heap of gaps finds the closest pair, and
+    // stale gaps (whose bins were merged since) are skipped by version
+    size_t n = m_bins.size();
+    vector<size_t> next(n), prev(n), version(n, 0);
+    for(size_t i = 0; i < n; i++){
+        next[i] = i + 1;
+        prev[i] = i - 1;
+    }
+    typedef tuple<double, size_t, size_t, size_t> Gap;
+    priority_queue<Gap, vector<Gap>, greater<Gap>> gaps;
+    for(size_t i = 0; i + 1 < n; i++){
+        gaps.push(Gap(m_bins[i + 1].first - m_bins[i].first, i, 0, 0));
+    }
+
+    size_t alive = n;
+    // WHILE: Too many bins, merge the closest pair into its weighted mean
+    while(alive > m_maxBins){
+        auto [gap, left, leftVersion, rightVersion] = gaps.top();
+        gaps.pop();
+        size_t right = next[left];
+        if(right >= n || version[left] != leftVersion || version[right] != rightVersion){
+            continue;
+        }
+        pair<double, uint64_t> & a = m_bins[left];
+        pair<double, uint64_t> & b = m_bins[right];
+        uint64_t count = a.second + b.second;
+        a.first = (a.first * a.second + b.first * b.second) / count;
+        a.second = count;
+        b.second = 0;
+        next[left] = next[right];
+        if(next[right] < n){
+            prev[next[right]] = left;
+        }
+        version[left]++;
+        version[right]++;
+        alive--;
+
+        if(left > 0 && prev[left] < n){
+            size_t p = prev[left];
+            gaps.push(Gap(a.first - m_bins[p].first, p, version[p], version[left]));
+        }
+        if(next[left] < n){
+            size_t r = next[left];
+            gaps.push(Gap(m_bins[r].first - a.first, left, version[left], version[r]));
+        }
+    }
+
+    // Keep the bins that were not merged away
+    vector<pair<double, uint64_t>> bins;
+    bins.reserve(alive);
+    for(size_t i = 0; i < n; i = next[i]){
+        bins.push_back(m_bins[i]);
+    }
+    m_bins.swap(bins);
+}
+
+vector<double> QuantileSketch::quantiles(size_t numParts){
+    flush();
+    vector<double> points;
+    if(m_bins.empty() || numParts < 2){
+        return points;
+    }
+    uint64_t total = 0;
+    for(const auto & bin : m_bins){
+        total += bin.second;
+    }
+
+    // Half of each bin's count is assumed to lie on either side of its centroid
+    size_t i = 0;
+    double before = m_bins[0].second / 2.0;
+    for(size_t j = 1; j < numParts; j++){
+        double target = (double) total * j / numParts;
+        // WHILE: Target lies past the next centroid, move to the next pair of bins
+        while(i + 1 < m_bins.size() && before + (m_bins[i].second + m_bins[i + 1].second) / 2.0 <= target){
+            before += (m_bins[i].second + m_bins[i + 1].second) / 2.0;
+            i++;
+        }
+        // IF: Target lies outside the centroids, clamp to the nearest one
+        if(target < before || i + 1 == m_bins.size()){
+            points.push_back(m_bins[i].first);
+            continue;
+        }
+
+        // Solve for the point where the trapezoid between the centroids holds the remainder
+        double d = target - before;
+        double mi = m_bins[i].second, mj = m_bins[i + 1].second;
+        double a = mj - mi, b = 2 * mi, c = -2 * d;
+        double z = a == 0 ? -c / b : (-b + sqrt(b * b - 4 * a * c)) / (2 * a);
+        points.push_back(m_bins[i].first + (m_bins[i + 1].first - m_bins[i].first) * z);
+    }
+    return points;
+}
@@ -0,0 +1,51 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the quantile sketch class.
+    @file quantileSketch.hpp
+
+    This class summarizes a stream of numbers in
+    a bounded number of (centroid, count) bins, as
+    in the streaming histogram of Ben-Haim and
+    Tom-Tov, and estimates quantiles from them. */
+
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class QuantileSketch {
+public:
+    QuantileSketch(std::size_t maxBins)
+        : m_maxBins(maxBins < 2 ? 2 : maxBins), m_exact(true) { }
+
+    /* Adds a value. Values are buffered and folded into the bins a
+       buffer at a time, merging the closest bins while there are too many. */
+    void add(double value);
+
+    /* Checks if no bins were ever merged, i.e. each bin is one distinct value. */
+    bool isExact();
+
+    /* Gets the bins, in increasing order of centroid. */
+    const std::vector<std::pair<double, std::uint64_t>> & getBins();
+
+    /* Estimates the points splitting the values into numParts parts of equal count.
+       @returns numParts - 1 non-decreasing points. */
+    std::vector<double> quantiles(std::size_t numParts);
+
+private:
+    std::size_t m_maxBins;
+    bool m_exact;
+    std::vector<std::pair<double, std::uint64_t>> m_bins;
+    std::vector<double> m_buffer;
+
+    /* Folds the buffered values into the bins. */
+    void flush();
+
+    /* Merges closest neighboring bins until at most m_maxBins are left. */
+    void compress();
+};
+#endif
@@ -0,0 +1,154 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the result cache class.
+    @file resultCache.cpp
+
+    This class keeps written rulesets in a directory,
+    keyed by dataset contents and options. */
+
+#include "resultCache.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <utime.h>
+#include <vector>
+
+using namespace std;
+
+/* Suffix of entry files; anything else in the directory is left alone. */
+static const string ENTRY_SUFFIX = ".rules";
+
+bool ResultCache::create(){
+    if(mkdir(m_directory.c_str(), 0700) != 0 && errno != EEXIST){
+        return false;
+    }
+    struct stat info;
+    return stat(m_directory.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+uint64_t ResultCache::makeKey(uint64_t datasetHash, const Options & options){
+    // Only options that change the rules; e.g. selection and workers do not
+    stringstream fields;
+    fields << datasetHash << ' ' << options.cutpointMode << ' '
+           << (options.cutpointMode == CUT_QUANTILE ? options.maxCutpoints : 0) << ' '
+           << options.collapseDuplicates << ' ' << options.sampleFraction << ' '
+           << (options.speculativeSeeds > 1 ? options.speculativeSeeds : 0);
+    return hashString(fields.str());
+}
+
+bool ResultCache::fetch(uint64_t key, ostream & out){
+    string entry = entryFile(key);
+    ifstream file(entry, ios::binary);
+    if(!file){
+        lock_guard<mutex> guard(m_lock);
+        m_misses++;
+        return false;
+    }
+    // An empty ruleset has no buffer to copy
+    if(file.peek() != ifstream::traits_type::eof()){
+        out << file.rdbuf();
+    }
+    // Mark the entry as recently used
+    utime(entry.c_str(), nullptr);
+
+    lock_guard<mutex> guard(m_lock);
+    m_hits++;
+    return true;
+}
+
+bool ResultCache::store(uint64_t key, string filename){
+    ifstream rules(filename, ios::binary);
+    if(!rules){
+        return false;
+    }
+    string entry = entryFile(key);
+    stringstream tmpName;
+    tmpName << entry << ".tmp" << getpid() << "-" << this_thread::get_id();
+    ofstream file(tmpName.str(), ios::binary);
+    if(rules.peek() != ifstream::traits_type::eof()){
+        file << rules.rdbuf();
+    }
+    file.close();
+    // Only a complete entry is renamed into place
+    if(!file || rename(tmpName.str().c_str(), entry.c_str()) != 0){
+        unlink(tmpName.str().c_str());
+        return false;
+    }
+
+    lock_guard<mutex> guard(m_lock);
+    m_stores++;
+    size_t numEntries = 0;
+    evict(numEntries);
+    return true;
+}
+
+void ResultCache::report(ostream & stream){
+    lock_guard<mutex> guard(m_lock);
+    size_t numEntries = 0;
+    size_t bytes = evict(numEntries);
+    stream << "Result cache: " << m_hits << " hits, " << m_misses << " misses, "
+           << m_stores << " stored, " << m_evictions << " evicted; " << numEntries
+           << " entries, " << bytes << " of " << m_budget << " bytes" << endl;
+}
+
+string ResultCache::entryFile(uint64_t key) const {
+    stringstream name;
+    name << m_directory << "/" << hex << key << ENTRY_SUFFIX;
+    return name.str();
+}
+
+size_t ResultCache::evict(size_t & numEntries){
+    struct Entry {
+        string path;
+        time_t mtime;
+        size_t bytes;
+    };
+    vector<Entry> entries;
+    size_t bytes = 0;
+
+    DIR * dir = opendir(m_directory.c_str());
+    if(!dir){
+        numEntries = 0;
+        return 0;
+    }
+    // FOR: Each entry file of the directory, note its age and size
+    while(struct dirent * item = readdir(dir)){
+        string name = item->d_name;
+        if(name.size() <= ENTRY_SUFFIX.size()
+           || name.compare(name.size() - ENTRY_SUFFIX.size(), ENTRY_SUFFIX.size(), ENTRY_SUFFIX) != 0){
+            continue;
+        }
+        string path = m_directory + "/" + name;
+        struct stat info;
+        if(stat(path.c_str(), &info) == 0){
+            entries.push_back({path, info.st_mtime, (size_t) info.st_size});
+            bytes += info.st_size;
+        }
+    }
+    closedir(dir);
+
+    // Least recently used first; equal times by name, so eviction is repeatable
+    sort(entries.begin(), entries.end(), [](const Entry & a, const Entry & b){
+        return a.mtime != b.mtime ? a.mtime < b.mtime : a.path < b.path;
+    });
+    size_t evicted = 0;
+    // WHILE: Over budget, remove the oldest entry
+    while(bytes > m_budget && evicted < entries.size()){
+        if(unlink(entries[evicted].path.c_str()) == 0){
+            bytes -= entries[evicted].bytes;
+            m_evictions++;
+        }
+        evicted++;
+    }
+    numEntries = entries.size() - evicted;
+    return bytes;
+}
@@ -0,0 +1,66 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the result cache class.
+    @file resultCache.hpp
+
+    This class keeps written rulesets in a directory,
+    one file per key, where the key hashes the parsed
+    dataset (its tokens, so comments and whitespace do
+    not matter) and the options that change the rules.
+    Entries are written to a temporary file and renamed
+    into place, a hit refreshes the entry's modification
+    time, and the least recently used entries are removed
+    when the directory grows past its budget. */
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+#include "options.hpp"
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+class ResultCache {
+public:
+    ResultCache(std::string directory, std::size_t budgetBytes)
+        : m_directory(directory), m_budget(budgetBytes), m_hits(0), m_misses(0),
+          m_stores(0), m_evictions(0) { }
+
+    /* Creates the cache directory if it does not exist.
+       @returns True if the directory can be used; false, otherwise. */
+    bool create();
+
+    /* Combines a dataset hash with the options that change the rules. */
+    static std::uint64_t makeKey(std::uint64_t datasetHash, const Options & options);
+
+    /* Copies the cached ruleset of a key to a stream.
+       @returns True on a hit; false, otherwise. */
+    bool fetch(std::uint64_t key, std::ostream & out);
+
+    /* Copies a written ruleset into the cache, then evicts the least
+       recently used entries until within budget.
+       @returns True if the entry was stored; false, otherwise. */
+    bool store(std::uint64_t key, std::string filename);
+
+    /* Prints hits, misses, stores and evictions so far, and the entries left. */
+    void report(std::ostream & stream);
+
+private:
+    std::string m_directory;
+    std::size_t m_budget;
+    std::size_t m_hits;
+    std::size_t m_misses;
+    std::size_t m_stores;
+    std::size_t m_evictions;
+    std::mutex m_lock;
+
+    /* Gets the entry file of a key. */
+    std::string entryFile(std::uint64_t key) const;
+
+    /* Removes the oldest entries until the directory is within budget.
+       @returns Bytes of the entries left. */
+    std::size_t evict(std::size_t & numEntries);
+};
+#endif
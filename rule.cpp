@@ -11,10 +11,8 @@
 
 using namespace std;
 
-int Rule::idCount = 0;
-
 Rule::Rule() :
-    id(idCount++){ }
+    id(-1){ }
 
 void Rule::addCondition(int index){
     m_conditions.insert(index);
@@ -39,15 +37,24 @@ set<int> Rule::getConditions() const {
     return m_conditions;
 }
 
-set<int> Rule::getBlock(vector<AV *> avBlocks) const {
+set<int> Rule::getBlock(const vector<AV *> & avBlocks) const {
     if(m_conditions.empty()){
         return m_conditions;
     }
-    vector<set<int>> blocks;
+    // Start from the smallest block, so the others are only read where it has cases
+    int smallest = *m_conditions.begin();
     for(int i : m_conditions){
-        blocks.push_back(avBlocks[i]->getBlock());
+        if(avBlocks[i]->size() < avBlocks[smallest]->size()){
+            smallest = i;
+        }
+    }
+    set<int> block = avBlocks[smallest]->getBlock();
+    for(int i : m_conditions){
+        if(i != smallest){
+            block = avBlocks[i]->intersect(block);
+        }
     }
-    return (setsIntersection(blocks));
+    return block;
 }
 
 set<int> Rule::getAttributeGroup(vector<AV *> avBlocks, int index) const {
@@ -65,10 +72,14 @@ void Rule::mergeIntervals(vector<AV *> avBlocks){
         return;
     }
     for(auto first = m_conditions.begin(); first != m_conditions.end();){
-        cout << "first: " << (*first);
+        #if DEBUG==true
+            cout << "first: " << (*first);
+        #endif
         bool modified = false;
         for(auto second = next(first); second != m_conditions.end();){
-            cout << "  second: " << (*second) << endl;
+            #if DEBUG==true
+                cout << "  second: " << (*second) << endl;
+            #endif
             // IF: Current block is numeric
             if(avBlocks[(*first)]->isNumeric()){
                 // IF: Blocks share the same attribute
@@ -96,7 +107,9 @@ void Rule::mergeIntervals(vector<AV *> avBlocks){
                             avBlocks.push_back(new AVNumeric(avBlocks[(*first)]->getAttr(), -1, mergedMin, mergedMax));
                             avBlocks[pos]->setBlock(setIntersection(avBlocks[(*first)]->getBlock(), avBlocks[(*second)]->getBlock()));            
                         }
-                        cout << "pos: " << pos << endl;
+                        #if DEBUG==true
+                            cout << "pos: " << pos << endl;
+                        #endif
 
                         // Update set of conditions
                         // IF: Second immediately follows first
@@ -121,25 +134,29 @@ void Rule::mergeIntervals(vector<AV *> avBlocks){
     } // end for
 }
 
-void Rule::dropConditions(vector<AV *> avBlocks, set<int> B){ 
+size_t Rule::dropConditions(vector<AV *> avBlocks, set<int> B){ 
     // IF: Rule has one or less condition
     if(m_conditions.size() <= 1){
-        return;
+        return 0;
     }
+    size_t dropped = 0;
     // Else: Rule has at least two conditions
     set<int>::iterator iter;
     for(iter = m_conditions.begin(); iter != m_conditions.end();){
         Rule r = *this;
         r.removeCondition(*iter);
-        if(subsetEq(r.getBlock(avBlocks), B)){
+        // IF: Rest of the rule is still consistent (an empty rule covers nothing, so keep the last condition)
+        if(!r.empty() && subsetEq(r.getBlock(avBlocks), B)){
             #if DEBUG==true
                 cout << "Dropping condition " << avBlocks[*iter]->labelString() << endl;
             #endif
             iter = m_conditions.erase(iter);
+            dropped++;
         } else {
             iter++;
         }
     }
+    return dropped;
 }
 
 string Rule::toString(vector<AV *> avBlocks) const {
@@ -14,11 +14,8 @@
 #define DEBUG false
 
 class Rule {
-    /* Global to track current ID. */
-    static int idCount;
-
 public:
-    /* Constructs new rule with unique ID. */
+    /* Constructs new rule; it gets its ID when added to a covering. */
     Rule();
 
     /* Adds (the index of) a single condition from the rule. */  
@@ -39,7 +36,7 @@ public:
 
     /* Retrieves the intersection of all attribute-value pairs in the rule.
        @param avBlocks, array of attribute-value blocks. */
-    std::set<int> getBlock(std::vector<AV *> avBlocks) const;
+    std::set<int> getBlock(const std::vector<AV *> & avBlocks) const;
 
     /* Retrieves the intersections of all conditions with the same attribute as given condition. */
     std::set<int> getAttributeGroup(std::vector<AV *> avBlocks, int index) const;
@@ -49,8 +46,9 @@ public:
     void mergeIntervals(std::vector<AV *> avBlocks);
 
     /* Optimizes rule by linearly dropping unnecessary conditions.
-       @param B, set for the concept. */
-    void dropConditions(std::vector<AV *> avBlocks, std::set<int> B);
+       @param B, set for the concept.
+       @returns Number of conditions dropped. */
+    std::size_t dropConditions(std::vector<AV *> avBlocks, std::set<int> B);
 
     /* Converts rule to string, with format (A1, V1) & ... & (AN, VN). */
     std::string toString(std::vector<AV *> avBlocks) const;
@@ -61,8 +59,9 @@ public:
     /* Checks if rule is empty (i.e. has no conditions). */
     bool empty() const;
 
-    /* Unique identifier for the rule. */
-    const int id;
+    /* Position of the rule in its covering, in order of addition;
+       -1 until added (see LocalCover::addRule). */
+    int id;
     
     /* Set of indices of selected conditions for rule. */
     std::set<int> m_conditions;
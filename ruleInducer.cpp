@@ -0,0 +1,113 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the rule inducer class.
+    @file ruleInducer.cpp
+
+    This class is the in-memory entry point of
+    libmlem2. */
+
+#include "algorithm.hpp"
+#include "ruleInducer.hpp"
+#include <chrono>
+
+using namespace std;
+
+RuleInducer::RuleInducer(vector<string> attributes, string decision)
+    : m_attributes(attributes), m_decision(decision), m_columns(attributes.size() + 1) { }
+
+size_t RuleInducer::getNumAttributes() const {
+    return m_attributes.size();
+}
+
+bool RuleInducer::setColumn(size_t col, vector<string> values){
+    if(col >= m_columns.size()){
+        return false;
+    }
+    m_columns[col] = move(values);
+    return true;
+}
+
+bool RuleInducer::induce(const Options & options, vector<InducedRule> & rules, string & error) const {
+    auto start = chrono::steady_clock::now();
+    size_t numCases = m_columns.back().size();
+    // FOR: Each column, check it has a value for every case
+    for(unsigned c = 0; c < m_columns.size(); c++){
+        if(m_columns[c].size() != numCases){
+            error = "column " + to_string(c) + " has " + to_string(m_columns[c].size())
+                    + " values, the decision column " + to_string(numCases);
+            return false;
+        }
+    }
+    if(numCases == 0){
+        error = "no cases";
+        return false;
+    }
+
+    // Cases are added row by row, as the parser adds them
+    Dataset data(m_attributes.size() + 1);
+    for(const string & attribute : m_attributes){
+        data.addAttribute(attribute);
+    }
+    data.setDecision(m_decision);
+    for(size_t r = 0; r < numCases; r++){
+        for(unsigned c = 0; c < m_columns.size(); c++){
+            data.addValue(c, m_columns[c][r]);
+        }
+    }
+    if(options.collapseDuplicates){
+        data.collapseDuplicates();
+    }
+    if(options.renumberCases){
+        data.renumberCases();
+    }
+    const vector<size_t> * weights = data.getWeights();
+
+    Algorithm mlem2(m_attributes.size());
+    mlem2.setWarnings(nullptr);
+    mlem2.setCutpointMode(options.cutpointMode, options.maxCutpoints);
+    mlem2.setSelection(options.selection);
+    mlem2.setWeights(weights);
+    mlem2.setInputCases(data.getInputCases());
+    mlem2.setSpeculation(options.speculativeSeeds, options.numThreads);
+    if(options.deadlineSeconds > 0){
+        mlem2.setDeadline(start + chrono::duration_cast<chrono::steady_clock::duration>(
+                              chrono::duration<double>(options.deadlineSeconds)));
+    }
+    mlem2.generateAVBlocks(&data);
+    vector<AV *> blocks = mlem2.getAVBlocks();
+
+    // FOR: Each concept, induce its covering and convert its rules
+    for(Concept * concept : mlem2.generateConcepts(&data)){
+        LocalCover lc = mlem2.induceRules(concept);
+        set<int> B = concept->getBlock();
+        for(Rule * rule : lc.getRules()){
+            InducedRule induced;
+            induced.decision = concept->getDecision();
+            induced.value = concept->getValue();
+            set<int> block = rule->getBlock(blocks);
+            induced.specificity = rule->size();
+            induced.strength = weightedSize(setIntersection(block, B), weights);
+            induced.size = weightedSize(block, weights);
+            for(int c : rule->getConditions()){
+                RuleCondition condition = {blocks[c]->getAttr(), blocks[c]->isNumeric(), "", 0, 0};
+                if(condition.numeric){
+                    AVNumeric * numeric = (AVNumeric *) blocks[c];
+                    condition.lowerBound = numeric->getLowerBound();
+                    condition.upperBound = numeric->getUpperBound();
+                } else {
+                    condition.value = ((AVSymbolic *) blocks[c])->getValue();
+                }
+                induced.conditions.push_back(condition);
+            }
+            rules.push_back(induced);
+            delete rule;
+        }
+        delete concept;
+    }
+    for(AV * av : blocks){
+        delete av;
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the rule inducer class.
+    @file ruleInducer.hpp
+
+    This class is the in-memory entry point of
+    libmlem2: it builds a dataset from columns of
+    values, runs MLEM2 and returns the rules as
+    structures, without files or console output.
+    An inducer is only read while inducing, and
+    induction keeps no global state, so any number
+    of threads may induce at the same time, from
+    the same inducer or from different ones. */
+
+#ifndef RULE_INDUCER_H
+#define RULE_INDUCER_H
+#include "options.hpp"
+#include <string>
+#include <vector>
+
+/* One condition of a rule: (attribute, value) or (attribute, lower..upper). */
+struct RuleCondition {
+    std::string attribute;
+    bool numeric;
+
+    /* Value of a symbolic condition; empty for a numeric one. */
+    std::string value;
+
+    /* Interval of a numeric condition; 0 for a symbolic one. */
+    float lowerBound;
+    float upperBound;
+};
+
+/* One rule: its conditions imply (decision, value). */
+struct InducedRule {
+    std::vector<RuleCondition> conditions;
+    std::string decision;
+    std::string value;
+
+    /* Number of conditions. */
+    std::size_t specificity;
+
+    /* Cases of the concept the rule matches, weighted by multiplicity. */
+    std::size_t strength;
+
+    /* Cases the rule matches, weighted by multiplicity. */
+    std::size_t size;
+};
+
+class RuleInducer {
+public:
+    RuleInducer(std::vector<std::string> attributes, std::string decision);
+
+    /* Gets number of attributes (decision excluded). */
+    std::size_t getNumAttributes() const;
+
+    /* Sets the values of an attribute's column, one per case; the column
+       after the last attribute is the decision. Values are parsed as in
+       LERS files: numbers are numeric, anything else is symbolic.
+       @returns False if there is no such column. */
+    bool setColumn(std::size_t col, std::vector<std::string> values);
+
+    /* Induces rules for every concept, in the order the text output lists
+       them, with the cutpoint, selection, duplicate collapsing, speculation
+       and deadline options; options about files are ignored.
+       @param error, why induction failed, if it did.
+       @returns False if a column is missing or of a different length. */
+    bool induce(const Options & options, std::vector<InducedRule> & rules,
+                std::string & error) const;
+
+private:
+    std::vector<std::string> m_attributes;
+    std::string m_decision;
+
+    /* Attribute columns, then the decision column. */
+    std::vector<std::vector<std::string>> m_columns;
+};
+#endif
@@ -0,0 +1,254 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the shard coordinator class.
+    @file shardCoordinator.cpp
+
+    This class spreads the concepts of one ruleset
+    over worker processes, handing everything over
+    through files in a work directory. */
+
+#include "algorithm.hpp"
+#include "datasetSnapshot.hpp"
+#include "shardCoordinator.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+ShardCoordinator::ShardCoordinator(string prefix, size_t numWorkers, const Options & options)
+    : m_workDir(prefix), m_created(false), m_numWorkers(numWorkers), m_options(options),
+      m_failed(0), m_partial(false), m_hasDeadline(false) { }
+
+ShardCoordinator::~ShardCoordinator(){
+    wait();
+    // IF: Directory was not made by this run, it may hold someone else's files
+    if(!m_created){
+        return;
+    }
+    unlink((m_workDir + "/dataset.snap").c_str());
+    for(unsigned w = 0; w < m_shards.size(); w++){
+        unlink((m_workDir + "/shard-" + to_string(w) + ".txt").c_str());
+        for(int c : m_shards[w]){
+            unlink(conceptFile(c).c_str());
+            unlink((conceptFile(c) + ".tmp").c_str());
+        }
+    }
+    rmdir(m_workDir.c_str());
+}
+
+bool ShardCoordinator::create(){
+    string name = m_workDir + ".XXXXXX";
+    if(!mkdtemp(&name[0])){
+        return false;
+    }
+    m_workDir = name;
+    m_created = true;
+    return true;
+}
+
+void ShardCoordinator::setDeadline(chrono::steady_clock::time_point deadline){
+    m_hasDeadline = true;
+    m_deadline = deadline;
+}
+
+string ShardCoordinator::getWorkDir() const {
+    return m_workDir;
+}
+
+vector<vector<int>> ShardCoordinator::assign(const vector<Concept *> & concepts, size_t numWorkers){
+    vector<int> order(concepts.size());
+    for(unsigned i = 0; i < order.size(); i++){
+        order[i] = i;
+    }
+    // Largest concepts first; equal sizes keep concept order
+    stable_sort(order.begin(), order.end(), [&concepts](int a, int b){
+        return concepts[a]->getBlockSize() > concepts[b]->getBlockSize();
+    });
+
+    vector<vector<int>> shards(max(numWorkers, (size_t) 1));
+    vector<size_t> load(shards.size(), 0);
+    // FOR: Each concept, give it to the worker with the fewest cases so far
+    for(int c : order){
+        size_t w = min_element(load.begin(), load.end()) - load.begin();
+        shards[w].push_back(c);
+        load[w] += concepts[c]->getBlockSize();
+    }
+    return shards;
+}
+
+size_t ShardCoordinator::start(string snapshotFile, const vector<Concept *> & concepts){
+    m_shards = assign(concepts, m_numWorkers);
+    m_shardCases.assign(m_shards.size(), 0);
+    size_t started = 0;
+
+    // FOR: Each non-empty shard, write its file and start a worker on it
+    for(unsigned w = 0; w < m_shards.size(); w++){
+        if(m_shards[w].empty()){
+            continue;
+        }
+        string shardFile = m_workDir + "/shard-" + to_string(w) + ".txt";
+        ofstream shard(shardFile);
+        for(int c : m_shards[w]){
+            shard << c << " " << conceptFile(c) << '\n';
+            m_shardCases[w] += concepts[c]->getBlockSize();
+        }
+        shard.close();
+        if(!shard){
+            cerr << "Unable to write shard file: " << shardFile << endl;
+            continue;
+        }
+
+        vector<string> args = {"mlem2"};
+        if(m_options.selection == SELECT_BOUNDED){
+            args.push_back("--selection");
+            args.push_back("bounded");
+        }
+        if(m_options.speculativeSeeds > 1){
+            args.push_back("--speculate");
+            args.push_back(to_string(m_options.speculativeSeeds));
+            args.push_back("--jobs");
+            args.push_back(to_string(m_options.numThreads));
+        }
+        // IF: Deadline set, hand on the time left; a worker starting past it only covers quickly
+        if(m_hasDeadline){
+            chrono::duration<double> left = m_deadline - chrono::steady_clock::now();
+            stringstream seconds;
+            seconds << max(left.count(), 1e-9);
+            args.push_back("--deadline");
+            args.push_back(seconds.str());
+        }
+        args.push_back("--shard-worker");
+        args.push_back(snapshotFile);
+        args.push_back(shardFile);
+
+        pid_t pid = fork();
+        // IF: Child, become a worker; nothing is shared past this point
+        if(pid == 0){
+            vector<char *> argv;
+            for(string & arg : args){
+                argv.push_back(&arg[0]);
+            }
+            argv.push_back(nullptr);
+            execv("/proc/self/exe", argv.data());
+            _exit(127);
+        }
+        if(pid < 0){
+            cerr << "Unable to start worker " << w << endl;
+            continue;
+        }
+        m_pids.push_back(pid);
+        started++;
+    }
+    return started;
+}
+
+size_t ShardCoordinator::wait(){
+    for(pid_t pid : m_pids){
+        int status = 0;
+        if(waitpid(pid, &status, 0) < 0 || !WIFEXITED(status)){
+            m_failed++;
+        } else if(WEXITSTATUS(status) == WORKER_PARTIAL){
+            m_partial = true;
+        } else if(WEXITSTATUS(status) != 0){
+            m_failed++;
+        }
+    }
+    m_pids.clear();
+    return m_failed;
+}
+
+bool ShardCoordinator::isPartial() const {
+    return m_partial;
+}
+
+bool ShardCoordinator::appendOutput(int concept, ostream & file) const {
+    ifstream rules(conceptFile(concept));
+    if(!rules){
+        return false;
+    }
+    // An empty covering leaves an empty file, which has no buffer to copy
+    if(rules.peek() != ifstream::traits_type::eof()){
+        file << rules.rdbuf();
+    }
+    return true;
+}
+
+void ShardCoordinator::report(ostream & stream) const {
+    size_t used = 0;
+    stringstream loads;
+    for(unsigned w = 0; w < m_shards.size(); w++){
+        if(!m_shards[w].empty()){
+            loads << (used++ ? ", " : "") << m_shards[w].size() << " concepts/" << m_shardCases[w] << " cases";
+        }
+    }
+    stream << "Sharded over " << used << " workers (" << loads.str() << "); "
+           << m_failed << " failed" << endl;
+}
+
+int ShardCoordinator::runWorker(string snapshotFile, string shardFile, const Options & options){
+    DatasetSnapshot snapshot;
+    if(!snapshot.open(snapshotFile)){
+        cerr << "Worker: not a dataset snapshot: " << snapshotFile << endl;
+        return 1;
+    }
+    ifstream shard(shardFile);
+    if(!shard){
+        cerr << "Worker: unable to read shard file: " << shardFile << endl;
+        return 1;
+    }
+
+    Algorithm mlem2(snapshot.getNumAttributes());
+    mlem2.setWeights(snapshot.getWeights());
+    mlem2.setInputCases(snapshot.getInputCases());
+    mlem2.setSelection(options.selection);
+    if(options.speculativeSeeds > 1){
+        mlem2.setSpeculation(options.speculativeSeeds, options.numThreads);
+    }
+    if(options.deadlineSeconds > 0){
+        mlem2.setDeadline(chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(
+                              chrono::duration<double>(options.deadlineSeconds)));
+    }
+    mlem2.setAVBlocks(snapshot.loadAVBlocks());
+    vector<Concept *> concepts = snapshot.loadConcepts();
+
+    int concept = 0;
+    string outFile;
+    int status = 0;
+    // WHILE: Shard lists another concept, induce it into its own file
+    while(shard >> concept >> outFile){
+        if(concept < 0 || concept >= (int) concepts.size() || !concepts[concept]){
+            cerr << "Worker: invalid concept " << concept << endl;
+            status = 1;
+            continue;
+        }
+        string tmpName = outFile + ".tmp";
+        ofstream file(tmpName);
+        mlem2.generateRules(file, vector<Concept *>{concepts[concept]});
+        concepts[concept] = nullptr;
+        file.close();
+        // Only a complete file is renamed into place for the coordinator
+        if(!file || rename(tmpName.c_str(), outFile.c_str()) != 0){
+            cerr << "Worker: unable to write " << outFile << endl;
+            status = 1;
+        }
+    }
+    for(Concept * c : concepts){
+        delete c;
+    }
+    for(AV * av : mlem2.getAVBlocks()){
+        delete av;
+    }
+    return status == 0 && mlem2.isPartial() ? WORKER_PARTIAL : status;
+}
+
+string ShardCoordinator::conceptFile(int concept) const {
+    return m_workDir + "/concept-" + to_string(concept) + ".txt";
+}
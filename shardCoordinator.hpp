@@ -0,0 +1,96 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the shard coordinator class.
+    @file shardCoordinator.hpp
+
+    This class spreads the concepts of one ruleset
+    over worker processes. Everything passes through
+    files in a work directory, so workers share no
+    memory with the coordinator:
+        dataset snapshot    blocks and concepts (see datasetSnapshot.hpp)
+        shard-<w>.txt       "<concept index> <output file>" per line
+        concept-<c>.txt     rules of concept c, renamed into place when complete
+    Concepts are assigned largest first, each to the
+    worker with the fewest cases so far; the outputs
+    are merged in concept order. A worker that runs
+    out of time exits with WORKER_PARTIAL. */
+
+#ifndef SHARD_COORDINATOR_H
+#define SHARD_COORDINATOR_H
+#include "concept.hpp"
+#include "options.hpp"
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/* Exit status of a worker that completed its concepts after the deadline. */
+#define WORKER_PARTIAL 3
+
+class ShardCoordinator {
+public:
+    /* @param prefix, path the work directory's name starts with. */
+    ShardCoordinator(std::string prefix, std::size_t numWorkers, const Options & options);
+
+    /* Removes the files this run wrote to the work directory, then the
+       directory itself if it was created by this run and is now empty. */
+    ~ShardCoordinator();
+
+    /* Creates a new work directory: the prefix plus a unique suffix.
+       @returns True if successful; false, otherwise. */
+    bool create();
+
+    /* Makes workers stop refining at this point, as --deadline does. */
+    void setDeadline(std::chrono::steady_clock::time_point deadline);
+
+    /* Gets the work directory. */
+    std::string getWorkDir() const;
+
+    /* Assigns concepts largest first, each to the least loaded worker.
+       @returns Concept indices of each worker. */
+    static std::vector<std::vector<int>> assign(const std::vector<Concept *> & concepts,
+                                                std::size_t numWorkers);
+
+    /* Writes the shard files and starts one worker process per shard.
+       @returns Number of workers started. */
+    std::size_t start(std::string snapshotFile, const std::vector<Concept *> & concepts);
+
+    /* Waits for every worker to exit.
+       @returns Number of workers that failed. */
+    std::size_t wait();
+
+    /* Checks if a worker reached the deadline, so its rules are partial quality. */
+    bool isPartial() const;
+
+    /* Copies a concept's rules to a stream.
+       @returns False if its worker did not complete it. */
+    bool appendOutput(int concept, std::ostream & file) const;
+
+    /* Prints how concepts were spread and how the workers did. */
+    void report(std::ostream & stream) const;
+
+    /* Induces the concepts listed in a shard file from a snapshot;
+       this is the body of a worker process.
+       @returns Process exit status. */
+    static int runWorker(std::string snapshotFile, std::string shardFile, const Options & options);
+
+private:
+    std::string m_workDir;
+    bool m_created;
+    std::size_t m_numWorkers;
+    Options m_options;
+    std::vector<std::vector<int>> m_shards;
+    std::vector<std::size_t> m_shardCases;
+    std::vector<pid_t> m_pids;
+    std::size_t m_failed;
+    bool m_partial;
+    bool m_hasDeadline;
+    std::chrono::steady_clock::time_point m_deadline;
+
+    /* Gets the output file of a concept. */
+    std::string conceptFile(int concept) const;
+};
+#endif
@@ -0,0 +1,118 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the stats class.
+    @file stats.cpp
+
+    This class records per-phase timing and
+    hot-path counters for a single run. */
+
+#include "stats.hpp"
+#include "utils.hpp"
+#include <fstream>
+
+using namespace std;
+
+static const char * PHASE_NAMES[NUM_PHASES] = {
+    "parse", "blocks", "concepts", "induction", "selection",
+    "drop_conditions", "drop_rules", "output"
+};
+
+static const char * COUNTER_NAMES[NUM_COUNTERS] = {
+    "intersections", "selections", "candidates_scanned",
+    "inner_iterations", "rules_induced", "conditions_dropped",
+    "rules_dropped", "duplicate_blocks", "store_bytes_written",
+    "store_bytes_read", "store_major_faults", "rule_conditions",
+    "rule_strength", "speculative_rules", "speculative_discarded",
+    "result_cache_hits", "result_cache_misses", "deadline_quick_rules",
+    "deadline_skipped_drop_conditions", "deadline_skipped_drop_rules", "block_runs"
+};
+
+Stats::Stats() : m_maxCandidates(0) {
+    for(unsigned i = 0; i < NUM_PHASES; i++){
+        m_times[i] = 0;
+    }
+    for(unsigned i = 0; i < NUM_COUNTERS; i++){
+        m_counters[i] = 0;
+    }
+}
+
+void Stats::addTime(Phase phase, double seconds){
+    m_times[phase] += seconds;
+}
+
+void Stats::count(Counter counter, uint64_t n){
+    m_counters[counter] += n;
+}
+
+void Stats::recordSelection(size_t n){
+    m_counters[COUNT_SELECTIONS]++;
+    m_counters[COUNT_CANDIDATES_SCANNED] += n;
+    if(n > m_maxCandidates){
+        m_maxCandidates = n;
+    }
+}
+
+void Stats::addConcept(string label, double seconds, size_t numRules){
+    m_concepts.push_back({label, seconds, numRules});
+}
+
+void Stats::merge(const Stats & other, string prefix){
+    for(unsigned i = 0; i < NUM_PHASES; i++){
+        m_times[i] += other.m_times[i];
+    }
+    for(unsigned i = 0; i < NUM_COUNTERS; i++){
+        m_counters[i] += other.m_counters[i];
+    }
+    if(other.m_maxCandidates > m_maxCandidates){
+        m_maxCandidates = other.m_maxCandidates;
+    }
+    for(const ConceptTime & c : other.m_concepts){
+        m_concepts.push_back({prefix + c.label, c.seconds, c.numRules});
+    }
+}
+
+uint64_t Stats::getCount(Counter counter) const {
+    return m_counters[counter];
+}
+
+double Stats::getTime(Phase phase) const {
+    return m_times[phase];
+}
+
+bool Stats::writeJson(string filename) const {
+    ofstream file;
+    file.open(filename);
+
+    // Unable to open file; Signal with boolean
+    if(!file) {
+        return false;
+    }
+
+    file << "{\n  \"phases\": {";
+    for(unsigned i = 0; i < NUM_PHASES; i++){
+        file << (i ? ", " : "") << "\"" << PHASE_NAMES[i] << "\": " << m_times[i];
+    }
+    file << "},\n  \"counters\": {";
+    for(unsigned i = 0; i < NUM_COUNTERS; i++){
+        file << (i ? ", " : "") << "\"" << COUNTER_NAMES[i] << "\": " << m_counters[i];
+    }
+    file << "},\n  \"selection\": {\"calls\": " << m_counters[COUNT_SELECTIONS]
+         << ", \"max_candidates\": " << m_maxCandidates << ", \"mean_candidates\": ";
+    if(m_counters[COUNT_SELECTIONS] > 0){
+        file << (double) m_counters[COUNT_CANDIDATES_SCANNED] / m_counters[COUNT_SELECTIONS];
+    } else {
+        file << 0;
+    }
+    file << "},\n  \"concepts\": [";
+    for(unsigned i = 0; i < m_concepts.size(); i++){
+        file << (i ? "," : "") << "\n    {\"concept\": \"" << jsonEscape(m_concepts[i].label)
+             << "\", \"seconds\": " << m_concepts[i].seconds
+             << ", \"rules\": " << m_concepts[i].numRules << "}";
+    }
+    file << "\n  ]\n}\n";
+
+    file.close();
+    return true;
+}
@@ -0,0 +1,107 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the stats class.
+    @file stats.hpp
+
+    This class records per-phase timing and
+    hot-path counters for a single run. */
+
+#ifndef STATS_H
+#define STATS_H
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum Phase {
+    PHASE_PARSE, PHASE_BLOCKS, PHASE_CONCEPTS, PHASE_INDUCTION, PHASE_SELECTION,
+    PHASE_DROP_CONDITIONS, PHASE_DROP_RULES, PHASE_OUTPUT, NUM_PHASES
+};
+
+enum Counter {
+    COUNT_INTERSECTIONS, COUNT_SELECTIONS, COUNT_CANDIDATES_SCANNED,
+    COUNT_INNER_ITERATIONS, COUNT_RULES_INDUCED, COUNT_CONDITIONS_DROPPED,
+    COUNT_RULES_DROPPED, COUNT_DUPLICATE_BLOCKS, COUNT_STORE_BYTES_WRITTEN,
+    COUNT_STORE_BYTES_READ, COUNT_STORE_MAJOR_FAULTS, COUNT_RULE_CONDITIONS,
+    COUNT_RULE_STRENGTH, COUNT_SPECULATIVE_RULES, COUNT_SPECULATIVE_DISCARDED,
+    COUNT_RESULT_CACHE_HITS, COUNT_RESULT_CACHE_MISSES, COUNT_DEADLINE_QUICK_RULES,
+    COUNT_DEADLINE_SKIPPED_DROP_CONDITIONS, COUNT_DEADLINE_SKIPPED_DROP_RULES, COUNT_BLOCK_RUNS,
+    NUM_COUNTERS
+};
+
+class Stats {
+public:
+    Stats();
+
+    /* Adds elapsed wall time to a phase. */
+    void addTime(Phase phase, double seconds);
+
+    /* Increments a counter. */
+    void count(Counter counter, std::uint64_t n = 1);
+
+    /* Records one getOptimalCondition call that scanned n candidates. */
+    void recordSelection(std::size_t n);
+
+    /* Records wall time and rule count for a finished concept. */
+    void addConcept(std::string label, double seconds, std::size_t numRules);
+
+    /* Adds another run's values; its concepts are labelled with the prefix. */
+    void merge(const Stats & other, std::string prefix);
+
+    std::uint64_t getCount(Counter counter) const;
+    double getTime(Phase phase) const;
+
+    /* Writes all recorded values as JSON.
+       @returns True if file write is successful; false, otherwise. */
+    bool writeJson(std::string filename) const;
+
+private:
+    struct ConceptTime {
+        std::string label;
+        double seconds;
+        std::size_t numRules;
+    };
+
+    double m_times[NUM_PHASES];
+    std::uint64_t m_counters[NUM_COUNTERS];
+    std::size_t m_maxCandidates;
+    std::vector<ConceptTime> m_concepts;
+};
+
+/* Adds the lifetime of the object to a phase. Does nothing
+   (not even reading the clock) when stats are disabled. */
+class ScopedTimer {
+public:
+    ScopedTimer(Stats * stats, Phase phase)
+        : m_stats(stats), m_phase(phase) {
+        if(m_stats){
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+    ~ScopedTimer(){
+        stop();
+    }
+
+    /* Records the phase early.
+       @returns Elapsed seconds, or 0 if stats are disabled. */
+    double stop(){
+        double seconds = 0;
+        if(m_stats){
+            seconds = elapsed();
+            m_stats->addTime(m_phase, seconds);
+            m_stats = nullptr;
+        }
+        return seconds;
+    }
+    double elapsed() const {
+        std::chrono::duration<double> d = std::chrono::steady_clock::now() - m_start;
+        return d.count();
+    }
+private:
+    Stats * m_stats;
+    Phase m_phase;
+    std::chrono::steady_clock::time_point m_start;
+};
+#endif
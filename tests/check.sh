@@ -0,0 +1,88 @@
+#!/bin/sh
+# Author: Kristi Daigh
+# Project: MLEM2 Rule Induction
+# Date: 11/20/2019
+#
+# Regression check: runs mlem2 on the datasets in tests/, alone and under
+# the options that change the output, and compares each output byte for
+# byte with its expected *_out.txt file.
+# Run from the top directory (make check) after building mlem2.
+
+MLEM2=./mlem2
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+failed=0
+
+# check <expected> <mlem2 arguments, ending with input and output>
+check(){
+    expected=$1
+    shift
+    if $MLEM2 "$@" > "$OUT/log" 2>&1 && cmp -s "$OUT/result" "$expected"; then
+        echo "ok      $*"
+    else
+        echo "FAILED  $* (expected $expected)"
+        cat "$OUT/log"
+        failed=1
+    fi
+    rm -f "$OUT/result"
+}
+
+# check_report <expected> <mlem2 arguments>: same as check, but without the
+# timing column of a cross-validation report
+check_report(){
+    expected=$1
+    shift
+    if $MLEM2 "$@" > "$OUT/log" 2>&1 && cut -f1-8 "$OUT/result" | cmp -s - "$expected"; then
+        echo "ok      $*"
+    else
+        echo "FAILED  $* (expected $expected)"
+        cat "$OUT/log"
+        failed=1
+    fi
+    rm -f "$OUT/result"
+}
+
+# Reference datasets
+for t in test test1 test2 test3 iris wine austr; do
+    check tests/${t}_out.txt tests/$t.txt "$OUT/result"
+done
+
+# Compressed and piped input must give the same rules as the plain text
+check tests/iris_out.txt tests/iris.txt.gz "$OUT/result"
+check tests/iris_out.txt tests/iris.txt.zst "$OUT/result"
+if $MLEM2 - "$OUT/piped" < tests/iris.txt.gz > "$OUT/log" 2>&1 && cmp -s "$OUT/piped" tests/iris_out.txt; then
+    echo "ok      - < tests/iris.txt.gz"
+else
+    echo "FAILED  - < tests/iris.txt.gz (expected tests/iris_out.txt)"
+    failed=1
+fi
+
+# Appended cases, plain and compressed
+check tests/iris_append_out.txt --append tests/iris_append.txt tests/iris_base.txt "$OUT/result"
+check tests/iris_append_out.txt --append tests/iris_append.txt.gz tests/iris_base.txt "$OUT/result"
+
+# Cutpoint modes
+check tests/iris_boundary_out.txt --cutpoints boundary tests/iris.txt "$OUT/result"
+check tests/iris_quantile_out.txt --cutpoints quantile --max-cutpoints 8 tests/iris.txt "$OUT/result"
+
+# Collapsed duplicates give the same rules with weighted counts
+check tests/iris_collapsed_out.txt --collapse-duplicates tests/iris.txt "$OUT/result"
+
+# Verified coverings, with and without appended cases and collapsing
+check tests/iris_out.txt --verify tests/iris.txt "$OUT/result"
+check tests/iris_collapsed_out.txt --verify --collapse-duplicates tests/iris.txt "$OUT/result"
+check tests/iris_append_out.txt --verify --append tests/iris_append.txt tests/iris_base.txt "$OUT/result"
+
+# Snapshots: written by one run and loaded by the next, also when comparing
+cp tests/iris.txt "$OUT/iris.txt"
+check tests/iris_out.txt --snapshot "$OUT/iris.txt" "$OUT/result"
+check tests/iris_speculate_out.txt --snapshot --speculate 3 --compare-speculation "$OUT/iris.txt" "$OUT/result"
+
+# Cross-validation report
+check_report tests/iris_cv_out.txt --cv 3 tests/iris.txt "$OUT/result"
+
+if [ $failed -ne 0 ]; then
+    echo "Some checks failed"
+    exit 1
+fi
+echo "All checks passed"
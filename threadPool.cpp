@@ -0,0 +1,83 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the thread pool class.
+    @file threadPool.cpp
+
+    This class runs submitted tasks on a fixed
+    set of worker threads. */
+
+#include "threadPool.hpp"
+
+using namespace std;
+
+ThreadPool::ThreadPool(size_t numThreads)
+    : m_pending(0), m_stopping(false) {
+    if(numThreads == 0){
+        numThreads = thread::hardware_concurrency();
+    }
+    if(numThreads == 0){
+        numThreads = 1;
+    }
+    for(size_t i = 0; i < numThreads; i++){
+        m_workers.push_back(thread(&ThreadPool::work, this));
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    wait();
+    {
+        lock_guard<mutex> guard(m_lock);
+        m_stopping = true;
+    }
+    m_taskReady.notify_all();
+    for(thread & worker : m_workers){
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(function<void()> task){
+    {
+        lock_guard<mutex> guard(m_lock);
+        m_tasks.push_back(task);
+        m_pending++;
+    }
+    m_taskReady.notify_one();
+}
+
+void ThreadPool::wait(){
+    unique_lock<mutex> guard(m_lock);
+    m_allDone.wait(guard, [this]{ return m_pending == 0; });
+}
+
+size_t ThreadPool::size() const {
+    return m_workers.size();
+}
+
+void ThreadPool::work(){
+    // WHILE: Pool is running
+    while(true){
+        function<void()> task;
+        {
+            unique_lock<mutex> guard(m_lock);
+            m_taskReady.wait(guard, [this]{ return m_stopping || !m_tasks.empty(); });
+            // IF: Pool is stopping and no work is left
+            if(m_tasks.empty()){
+                return;
+            }
+            task = m_tasks.front();
+            m_tasks.pop_front();
+        }
+
+        task();
+
+        {
+            lock_guard<mutex> guard(m_lock);
+            m_pending--;
+            if(m_pending == 0){
+                m_allDone.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,50 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the thread pool class.
+    @file threadPool.hpp
+
+    This class runs submitted tasks on a fixed
+    set of worker threads. */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    /* Starts the workers; zero selects one per hardware thread. */
+    ThreadPool(std::size_t numThreads = 0);
+
+    /* Waits for queued tasks, then stops the workers. */
+    ~ThreadPool();
+
+    /* Queues a task for the next free worker. */
+    void submit(std::function<void()> task);
+
+    /* Blocks until every submitted task has finished. */
+    void wait();
+
+    /* Gets number of worker threads. */
+    std::size_t size() const;
+
+private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_lock;
+    std::condition_variable m_taskReady;
+    std::condition_variable m_allDone;
+    std::size_t m_pending;
+    bool m_stopping;
+
+    /* Worker loop: runs tasks until the pool stops. */
+    void work();
+};
+#endif
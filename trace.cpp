@@ -0,0 +1,146 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Source file for the tracer.
+    @file trace.cpp
+
+    This class records timed spans into preallocated
+    per-thread ring buffers and exports them in the
+    Chrome trace-event format (Perfetto, chrome://tracing). */
+
+#include "trace.hpp"
+#include "utils.hpp"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+struct TraceEvent {
+    const char * name;
+    char detail[TRACE_DETAIL_SIZE];
+    uint64_t start;
+    uint64_t end;
+};
+
+struct TraceBuffer {
+    vector<TraceEvent> events;
+    size_t next;
+    uint64_t recorded;
+    int tid;
+};
+
+static atomic<bool> enabled(false);
+static size_t capacity = 0;
+static chrono::steady_clock::time_point epoch;
+static mutex registryLock;
+static vector<unique_ptr<TraceBuffer>> registry;
+
+/* Buffers of threads that have exited, keeping their events. */
+static vector<TraceBuffer *> freeBuffers;
+
+/* Holds a thread's buffer and frees it for reuse when the thread exits. */
+struct LocalBuffer {
+    TraceBuffer * buffer = nullptr;
+    ~LocalBuffer(){
+        if(buffer){
+            lock_guard<mutex> guard(registryLock);
+            freeBuffers.push_back(buffer);
+        }
+    }
+};
+static thread_local LocalBuffer localBuffer;
+
+/* Gets the calling thread's buffer: on first use, one freed by an exited
+   thread (recording continues after its events) or a new one. */
+static TraceBuffer * getLocalBuffer(){
+    if(!localBuffer.buffer){
+        lock_guard<mutex> guard(registryLock);
+        if(!freeBuffers.empty()){
+            localBuffer.buffer = freeBuffers.back();
+            freeBuffers.pop_back();
+        } else {
+            registry.push_back(unique_ptr<TraceBuffer>(new TraceBuffer()));
+            localBuffer.buffer = registry.back().get();
+            localBuffer.buffer->events.resize(capacity);
+            localBuffer.buffer->next = 0;
+            localBuffer.buffer->recorded = 0;
+            localBuffer.buffer->tid = registry.size();
+        }
+    }
+    return localBuffer.buffer;
+}
+
+void Tracer::enable(size_t eventsPerThread){
+    capacity = eventsPerThread > 0 ? eventsPerThread : 1;
+    epoch = chrono::steady_clock::now();
+    enabled = true;
+    getLocalBuffer();
+}
+
+bool Tracer::isEnabled(){
+    return enabled.load(memory_order_relaxed);
+}
+
+uint64_t Tracer::now(){
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+}
+
+void Tracer::record(const char * name, const char * detail, uint64_t start, uint64_t end){
+    TraceBuffer * buffer = getLocalBuffer();
+    TraceEvent & event = buffer->events[buffer->next];
+    event.name = name;
+    memcpy(event.detail, detail, TRACE_DETAIL_SIZE);
+    event.start = start;
+    event.end = end;
+    buffer->next = (buffer->next + 1) % buffer->events.size();
+    buffer->recorded++;
+}
+
+bool Tracer::writeJson(string filename){
+    ofstream file;
+    file.open(filename);
+
+    // Unable to open file; Signal with boolean
+    if(!file) {
+        return false;
+    }
+
+    lock_guard<mutex> guard(registryLock);
+    bool first = true;
+    file << fixed << setprecision(3);
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    // FOR: Each thread, print its buffer oldest event first
+    for(auto const & buffer : registry){
+        size_t size = buffer->events.size();
+        size_t count = buffer->recorded < size ? buffer->recorded : size;
+        size_t begin = buffer->recorded < size ? 0 : buffer->next;
+
+        file << (first ? "" : ",") << "\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+             << buffer->tid << ", \"args\": {\"name\": \"" << (buffer->tid == 1 ? "main" : "worker") << "\"}}";
+        first = false;
+        if(buffer->recorded > size){
+            file << ",\n{\"name\": \"dropped_events\", \"ph\": \"i\", \"s\": \"t\", \"ts\": 0, \"pid\": 1, \"tid\": "
+                 << buffer->tid << ", \"args\": {\"count\": " << buffer->recorded - size << "}}";
+        }
+        for(size_t i = 0; i < count; i++){
+            const TraceEvent & event = buffer->events[(begin + i) % size];
+            file << ",\n{\"name\": \"" << event.name << "\", \"cat\": \"mlem2\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                 << buffer->tid << ", \"ts\": " << event.start / 1000.0
+                 << ", \"dur\": " << (event.end - event.start) / 1000.0;
+            if(event.detail[0] != '\0'){
+                file << ", \"args\": {\"detail\": \"" << jsonEscape(event.detail) << "\"}";
+            }
+            file << "}";
+        }
+    }
+    file << "\n]}\n";
+
+    file.close();
+    return true;
+}
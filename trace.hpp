@@ -0,0 +1,74 @@
+// Author: Kristi Daigh
+// Project: MLEM2 Rule Induction
+// Date: 11/20/2019
+
+/** Header file for the tracer.
+    @file trace.hpp
+
+    This class records timed spans into preallocated
+    per-thread ring buffers and exports them in the
+    Chrome trace-event format (Perfetto, chrome://tracing). */
+
+#ifndef TRACE_H
+#define TRACE_H
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/* Longest detail string kept per span. */
+#define TRACE_DETAIL_SIZE 48
+
+class Tracer {
+public:
+    /* Starts recording; each thread gets a ring buffer of the given capacity.
+       A buffer outlives its thread and is handed on to the next new thread. */
+    static void enable(std::size_t eventsPerThread = 1 << 16);
+
+    /* Checks if spans are being recorded. */
+    static bool isEnabled();
+
+    /* Nanoseconds since tracing was enabled. */
+    static std::uint64_t now();
+
+    /* Appends a finished span to the calling thread's buffer.
+       The oldest event is overwritten when the buffer is full. */
+    static void record(const char * name, const char * detail,
+                       std::uint64_t start, std::uint64_t end);
+
+    /* Writes all recorded spans as trace-event JSON.
+       @returns True if file write is successful; false, otherwise. */
+    static bool writeJson(std::string filename);
+};
+
+/* Records its lifetime as a span. Does nothing when tracing is disabled. */
+class TraceSpan {
+public:
+    TraceSpan(const char * name, const char * detail = "")
+        : m_name(nullptr) {
+        if(Tracer::isEnabled()){
+            m_name = name;
+            strncpy(m_detail, detail, TRACE_DETAIL_SIZE - 1);
+            m_detail[TRACE_DETAIL_SIZE - 1] = '\0';
+            m_start = Tracer::now();
+        }
+    }
+    TraceSpan(const char * name, const std::string & detail)
+        : TraceSpan(name, detail.c_str()) { }
+    ~TraceSpan(){
+        end();
+    }
+
+    /* Ends the span early. */
+    void end(){
+        if(m_name){
+            Tracer::record(m_name, m_detail, m_start, Tracer::now());
+            m_name = nullptr;
+        }
+    }
+private:
+    const char * m_name;
+    char m_detail[TRACE_DETAIL_SIZE];
+    std::uint64_t m_start;
+};
+#endif
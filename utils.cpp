@@ -8,6 +8,8 @@
     utility functions for sets, etc. */
 
 #include "utils.hpp"
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 
 using namespace std;
@@ -107,6 +109,17 @@ set<int> setsUnion(vector<set<int> > sets){
     return result;
 }
 
+size_t weightedSize(const set<int> & set, const vector<size_t> * weights){
+    if(!weights){
+        return set.size();
+    }
+    size_t size = 0;
+    for(int x : set){
+        size += (*weights)[x];
+    }
+    return size;
+}
+
 bool subsetEq(set<int> setA, set<int> setB){
     if(setA.empty()){
         return true;
@@ -153,4 +166,48 @@ void printMap( map<int, set<int>> map ) {
         cout << "T[" << x << "] = ";
         printSet("", y);
     }
-}
\ No newline at end of file
+}
+
+uint64_t hashString(const string & str, uint64_t hash){
+    for(char c : str){
+        hash = (hash ^ (unsigned char) c) * 1099511628211ULL;
+    }
+    return hash * 1099511628211ULL;
+}
+
+string jsonEscape(string str){
+    string result;
+    for(char c : str){
+        // IF: Character must be escaped
+        if(c == '"' || c == '\\'){
+            result += '\\';
+            result += c;
+        } else if((unsigned char) c < 0x20){
+            char buffer[8];
+            snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            result += buffer;
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+bool hashFile(string filename, uint64_t & hash, uint64_t & size){
+    ifstream file(filename, ios::binary);
+    if(!file){
+        return false;
+    }
+    hash = 14695981039346656037ULL;
+    size = 0;
+    vector<char> buffer(1 << 16);
+    // WHILE: File has more bytes, fold them into the hash
+    while(file.read(buffer.data(), buffer.size()) || file.gcount() > 0){
+        size_t count = file.gcount();
+        for(size_t i = 0; i < count; i++){
+            hash = (hash ^ (unsigned char) buffer[i]) * 1099511628211ULL;
+        }
+        size += count;
+    }
+    return true;
+}
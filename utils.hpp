@@ -7,9 +7,13 @@
     This class provides project-wide
     utility functions for sets, etc. */
 
+#ifndef UTILS_H
+#define UTILS_H
 #include <algorithm>
+#include <cstdint>
 #include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 std::set<int> setDifference(std::set<int> setA, std::set<int> setB);
@@ -22,6 +26,9 @@ std::set<int> setUnion(std::set<int> setA, std::set<int> setB);
 
 std::set<int> setsUnion(std::vector<std::set<int> > sets);
 
+/* Sums the weights of the cases in a set; the set size if weights is null. */
+std::size_t weightedSize(const std::set<int> & set, const std::vector<std::size_t> * weights);
+
 bool subsetEq(std::set<int> setA, std::set<int> setB);
 
 bool commonElements(std::set<int> setA, std::set<int> setB);
@@ -30,4 +37,16 @@ void printSet(std::string label, std::set<int> set);
 
 void printList(std::string label, std::vector<std::set<int> > list);
 
-void printMap(std::map<int, std::set<int>> map);
\ No newline at end of file
+void printMap(std::map<int, std::set<int>> map);
+
+/* Computes the 64-bit FNV-1a hash of a file's contents.
+   @returns True if the file could be read; false, otherwise. */
+bool hashFile(std::string filename, std::uint64_t & hash, std::uint64_t & size);
+
+/* Folds a string and a terminating zero byte into a 64-bit FNV-1a hash,
+   so consecutive strings hash differently from their concatenation. */
+std::uint64_t hashString(const std::string & str, std::uint64_t hash = 14695981039346656037ULL);
+
+/* Escapes quotes, backslashes and control characters for a JSON string. */
+std::string jsonEscape(std::string str);
+#endif